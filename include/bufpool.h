@@ -0,0 +1,37 @@
+/* bufpool.h - bufhdr */
+
+#ifndef	NBPOOLS
+#define	NBPOOLS	20		/* Maximum number of buffer pools	*/
+#endif
+
+#ifndef	BP_MAXB
+#define	BP_MAXB	8192		/* Maximum buffer size in bytes		*/
+#endif
+
+#define	BP_MINB	8		/* Minimum buffer size in bytes		*/
+#ifndef	BP_MAXN
+#define	BP_MAXN	2048		/* Maximum number of buffers in a pool	*/
+#endif
+
+struct	bpentry	{		/* Description of a single buffer pool	*/
+	struct	bpentry *bpnext;/* pointer to next free buffer		*/
+	sid32	bpsem;		/* semaphore that counts buffers	*/
+				/*    currently available in the pool	*/
+	uint32	bpsize;		/* size of buffers in this pool		*/
+	};
+
+/* Header hidden in front of each buffer while it is allocated; it	*/
+/*   records the pool and the owning process, and links the buffer	*/
+/*   into the owner's inbox while a sendbuf is waiting for recvbuf	*/
+
+struct	bphdr	{
+	bpid32	bhpool;		/* Pool to which the buffer belongs	*/
+	pid32	bhowner;	/* Process that owns the buffer		*/
+	struct	bphdr *bhnext;	/* Next buffer in the owner's inbox	*/
+	bool8	bhqueued;	/* In an inbox, not yet received	*/
+	};
+
+#define	bufhdr(b)	((struct bphdr *)((char *)(b) - sizeof(struct bphdr)))
+
+extern	struct	bpentry buftab[];/* Buffer pool table			*/
+extern	bpid32	nbpools;	/* current number of allocated pools	*/
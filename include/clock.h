@@ -8,10 +8,20 @@
 
 
 #define CLKTICKS_PER_SEC  1000		/* clock timer resolution	*/
+#define	CLKCOUNTS	1193		/* 8254 input counts per tick	*/
+
+#ifdef	TICKLESS
+#define	CLKMAXIDLE	(65535 / CLKCOUNTS) /* Longest one-shot in ticks*/
+
+extern	uint32	clkoneshot;		/* ticks in the armed one-shot,	*/
+					/*   or 0 while ticking		*/
+#endif
 
 extern	uint32	clktime;		/* second since system boot	*/
 extern  uint32  ctr1000;        /* current time in msecs since boot     */
-extern  uint32	count1000;		/* ticks since clktime		*/
+extern  uint32	count1000;		/* ms left until clktime ticks	*/
 
-extern	qid16	sleepq;			/* queue for sleeping processes	*/
 extern	uint32	preempt;		/* preemption counter		*/
+
+extern	uint32	tsccycms;		/* TSC cycles per millisecond,	*/
+					/*   0 until delaycal has run	*/
@@ -0,0 +1,28 @@
+/* dwork.h - deferred work configuration */
+
+/* Interrupt handlers hand work they need not finish themselves to	*/
+/*   dwork, which puts a function and an argument in a ring and makes	*/
+/*   the deferred-work process ready.  The handler defers rescheduling	*/
+/*   until it ends, so that process, which runs above every other	*/
+/*   one, is switched in once the handler has finished, and work	*/
+/*   queued by several interrupts meanwhile is drained in one pass.	*/
+/*   Producers run with interrupts disabled and the process is the	*/
+/*   only consumer, so the ring needs no lock.  Items run with		*/
+/*   interrupts enabled and disable them only around the kernel state	*/
+/*   they touch.  If the process is killed, kill runs what is left	*/
+/*   and dwork refuses work until dwstart is called again.		*/
+
+#ifndef	DWLEN
+#define	DWLEN		64		/* Items in the ring (power of	*/
+#endif					/*   two)			*/
+
+#define	DWPRIO		1000		/* Above every other process,	*/
+					/*   the watchdog included	*/
+#define	DWSTK		4096		/* Stack size of the process	*/
+
+struct	dwent	{			/* One deferred work item	*/
+	void	(*dwfunc)(uint32);	/* Function to call		*/
+	uint32	dwarg;			/* Its argument			*/
+};
+
+extern	uint32	dwdropped;		/* Items refused, ring full	*/
@@ -0,0 +1,47 @@
+/* fiber.h - isbadfib */
+
+/* Fibers are cooperative threads that run inside a single process.	*/
+/*   Each has its own small stack, and switching between them saves	*/
+/*   only the callee-saved registers; the kernel never sees them, so	*/
+/*   a fiber that blocks in a kernel call blocks the whole process.	*/
+/*   The process that creates fibers runs them by calling fib_run,	*/
+/*   which returns once they have all exited.				*/
+
+#ifndef	NFIBER
+#define	NFIBER		4096		/* Fibers in the whole system	*/
+#endif
+
+#define	FIBMINSTK	1024		/* Smallest fiber stack		*/
+#define	FIBMAIN		(-2)		/* The process itself, running	*/
+					/*   fib_run rather than a fiber*/
+
+#define	FB_FREE		0		/* Fiber table entry is unused	*/
+#define	FB_READY	1		/* Fiber can run		*/
+#define	FB_CURR		2		/* Fiber is running		*/
+#define	FB_WAIT		3		/* Fiber waits on a fiber mutex	*/
+#define	FB_DEAD		4		/* Fiber exited, stack not freed*/
+
+struct	fibent	{			/* Entry in the fiber table	*/
+	byte	fbstate;		/* FB_FREE, FB_READY, etc.	*/
+	pid32	fbowner;		/* Process the fiber runs in	*/
+	char	*fbsp;			/* Saved stack pointer		*/
+	char	*fbstkbase;		/* Highest word of the stack	*/
+	uint32	fbstklen;		/* Stack length in bytes	*/
+	void	(*fbfunc)(void *);	/* Function the fiber runs	*/
+	void	*fbarg;			/* Argument to the function	*/
+	int32	fbnext;			/* Next fiber on a ready, mutex	*/
+					/*   wait, or free list		*/
+	int32	fbpnext;		/* Next and previous fiber of	*/
+	int32	fbpprev;		/*   the same owner		*/
+};
+
+extern	struct	fibent	fibtab[];
+
+struct	fibmutex {			/* Mutex that blocks fibers	*/
+	int32	fmowner;		/* Holding fiber, or EMPTY	*/
+	int32	fmhead;			/* First waiting fiber		*/
+	int32	fmtail;			/* Last waiting fiber		*/
+};
+
+#define	isbadfib(f)	(((int32)(f) < 0) || ((f) >= NFIBER) || \
+			 (fibtab[(f)].fbstate == FB_FREE))
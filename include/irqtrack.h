@@ -0,0 +1,34 @@
+/* irqtrack.h - interrupts-off window tracking */
+
+/* Built with -DIRQTRACK, every disable() that turns interrupts off	*/
+/*   (rather than nesting inside another) starts a window, and the	*/
+/*   restore() that turns them back on ends it.  Windows are charged	*/
+/*   to the file and line of the disable(), and the IRQTNSITE sites	*/
+/*   with the longest window are kept, with a count and total, for	*/
+/*   irqtrack_get and the irqtrack shell command.  Time spent in an	*/
+/*   interrupt handler before it calls disable(), and a window a	*/
+/*   context switch carries into a newly created process, are not	*/
+/*   seen.  Without IRQTRACK disable() and restore() are untouched.	*/
+
+#ifndef	IRQTNSITE
+#define	IRQTNSITE	16		/* Sites kept, longest first out*/
+#endif
+
+#ifndef	IRQTIF
+#define	IRQTIF		0x00000200	/* Interrupt enable bit of the	*/
+#endif					/*   mask (x86 EFLAGS.IF)	*/
+
+struct	irqtsite	{		/* One disable() call site	*/
+	char	*itfile;		/* Source file of the call	*/
+	int32	itline;			/* Line of the call		*/
+	uint32	itcount;		/* Windows it opened		*/
+	uint64	ittotal;		/* Cycles with interrupts off	*/
+	uint64	itmax;			/* Longest single window	*/
+};
+
+#ifdef	IRQTRACK
+
+#define	disable()	irqtrack_disable(__FILE__, __LINE__)
+#define	restore(m)	irqtrack_restore(m)
+
+#endif
@@ -0,0 +1,26 @@
+/* klog.h - klog configuration */
+
+/* Buffered kernel log.  klog only copies the format pointer and the	*/
+/*   32-bit arguments its conversions use (at most KLOGNARG) into a	*/
+/*   ring; a low-priority process started by klogstart formats them	*/
+/*   with kprintf later.  Formats must be string constants, and %s	*/
+/*   arguments must stay valid until the entry is printed.  When the	*/
+/*   ring is full the newest message is dropped and counted, and the	*/
+/*   drain reports the count.						*/
+
+#ifndef	KLOGLEN
+#define	KLOGLEN		256		/* Entries in the ring (power	*/
+#endif					/*   of two)			*/
+
+#define	KLOGNARG	8		/* Arguments kept per message	*/
+#define	KLOGPRIO	1		/* Priority of the drain process*/
+#define	KLOGPERIOD	10		/* ms between drain passes	*/
+#define	KLOGSTK		8192		/* Stack size of the drain	*/
+
+struct	klogent	{			/* One logged message		*/
+	uint32	klseq;			/* Ticket + 1 once written	*/
+	char	*klfmt;			/* kprintf format		*/
+	uint32	klarg[KLOGNARG];	/* Arguments, as passed		*/
+};
+
+extern	uint32	klogdropped;		/* Messages lost to overflow	*/
@@ -7,9 +7,64 @@
 #define NALOCKS 20      /* Maximum number of active locks that can be used	*/
 #define NPILOCKS 20     /* Maximum number of priority inversion locks that can be used	*/
 
+/* Per-lock contention statistics, built with -DLOCKSTAT. Every lock flavor
+   carries a lockstat_t and the LS_* hooks below update it; without LOCKSTAT
+   the field is absent and the hooks compile to nothing. */
+
+#define LS_SL 0         /* sl_lock_t	*/
+#define LS_LOCK 1       /* lock_t	*/
+#define LS_AL 2         /* al_lock_t	*/
+#define LS_PI 3         /* pi_lock_t	*/
+
+#define LSNBUCKET 8     /* Hold-time histogram buckets: bucket i counts holds of
+                           under 2^(10+2i) cycles, the last one everything longer */
+
+typedef struct lockstat_t
+{
+    uint32 acquires;    /* Times the lock was acquired	*/
+    uint32 contended;   /* Acquisitions that had to wait	*/
+    uint32 spins;       /* Failed test_and_set on guard (flag for sl_lock_t)	*/
+    uint32 backoffs;    /* sleepms(QUANTUM) calls while the guard was busy	*/
+    uint64 waittotal;   /* Cycles spent waiting in contended acquisitions	*/
+    uint64 waitmax;     /* Longest single wait	*/
+    uint64 holdstart;   /* When the current holder acquired the lock	*/
+    uint32 holdhist[LSNBUCKET];
+}lockstat_t;
+
+#ifdef LOCKSTAT
+#define LS_FIELD lockstat_t stat;
+#define LS_REGISTER(l, kind) lockstat_register(&(l)->stat, (kind), (l))
+#define LS_SPIN(l) ((l)->stat.spins++)
+#define LS_BACKOFF(l) ((l)->stat.backoffs++)
+#define LS_CONTEND(l) lockstat_contend(&(l)->stat)
+#define LS_ACQUIRE(l) lockstat_acquire(&(l)->stat)
+#define LS_RELEASE(l) lockstat_release(&(l)->stat)
+#else
+#define LS_FIELD
+#define LS_REGISTER(l, kind) ((void)0)
+#define LS_SPIN(l) ((void)0)
+#define LS_BACKOFF(l) ((void)0)
+#define LS_CONTEND(l) ((void)0)
+#define LS_ACQUIRE(l) ((void)0)
+#define LS_RELEASE(l) ((void)0)
+#endif
+
+/* An sl_lock_t holder runs with preemption disabled, so the timer does not
+   switch it out while others spin; build with -DSLPREEMPT to let it be
+   preempted as before, e.g. to compare the two with bench_lock. */
+
+#ifdef SLPREEMPT
+#define SL_NOPREEMPT() ((void)0)
+#define SL_PREEMPT() ((void)0)
+#else
+#define SL_NOPREEMPT() preempt_disable()
+#define SL_PREEMPT() preempt_enable()
+#endif
+
 typedef struct sl_lock_t
 {
     uint32 flag;
+    LS_FIELD
 }sl_lock_t;
 
 typedef struct lock_t
@@ -17,6 +72,7 @@ typedef struct lock_t
     uint32 flag;
     uint32 guard;
     qid16 queue;
+    LS_FIELD
 }lock_t;
 
 typedef struct al_lock_t
@@ -25,13 +81,18 @@ typedef struct al_lock_t
     uint32 guard;
     uint32 lock_id;
     qid16 queue;
+    LS_FIELD
 }al_lock_t;
 
+extern uint32 locks[];  /* Holder of each al_lock_t by lock_id, -1 if free */
+
 typedef struct pi_lock_t
 {
     uint32 flag;
     uint32 guard;
     qid16 queue;
     pid32 curr_holder;
+    struct pi_lock_t *next_held;    /* Next lock held by curr_holder */
+    LS_FIELD
 }pi_lock_t;
 
@@ -1,9 +1,14 @@
 /* process.h - isbadpid */
 
-/* Maximum number of processes in the system */
+/* Maximum number of processes in the system (build with -DBIGNPROC	*/
+/*   for the large configuration)					*/
 
 #ifndef NPROC
+#ifdef	BIGNPROC
+#define	NPROC		4096
+#else
 #define	NPROC		8
+#endif
 #endif		
 
 /* Process state constants */
@@ -16,12 +21,20 @@
 #define	PR_SUSP		5	/* Process is suspended			*/
 #define	PR_WAIT		6	/* Process is on semaphore queue	*/
 #define	PR_RECTIM	7	/* Process is receiving with timeout	*/
+#define	PR_SEND		8	/* Process waiting for mailbox space	*/
+#define	PR_JOIN		9	/* Process waiting for another to exit	*/
 
 /* Miscellaneous process definitions */
 
 #define	PNMLEN		16	/* Length of process "name"		*/
 #define	NULLPROC	0	/* ID of the null process		*/
 
+/* Depth of the per-process message mailbox */
+
+#ifndef	MBOXLEN
+#define	MBOXLEN		8	/* Messages that can be in flight	*/
+#endif
+
 /* Process initialization constants */
 
 #define	INITSTK		65536	/* Initial process stack size		*/
@@ -38,32 +51,114 @@
 
 #define NDESC		5	/* must be odd to make procent 4N bytes	*/
 
-/* Definition of the process table (multiple of 32 bits) */
+/* Definition of the process table (multiple of 32 bits).  The fields	*/
+/*   touched by every scheduling and lock operation are packed into the	*/
+/*   first PRHOTSIZE bytes, and each entry is aligned on that boundary,	*/
+/*   so the hot state of a process is always one cache line fetch; the	*/
+/*   names, descriptors, and message fields follow it			*/
+
+#ifndef	PRHOTSIZE
+#define	PRHOTSIZE	32	/* Bytes of hot state at entry start	*/
+#endif				/*   (64 on hosts with 64-bit pointers)	*/
 
 struct procent {		/* Entry in the process table		*/
+	/* Hot: scheduler and lock state */
 	uint16	prstate;	/* Process state: PR_CURR, etc.		*/
 	pri16	prprio;		/* Process priority			*/
 	char	*prstkptr;	/* Saved stack pointer			*/
+	uint32  runtime;    /* Number of milliseconds the process has been running   */
+	pi_lock_t *pendingLock;
+	pi_lock_t *piheld;  /* Priority inheritance locks this process holds */
+	int16   pendingLockId;  /* Lock number on which the process is awaiting  */ 
+	pri16 priority;
+	bool8   l_flag;     /* Flag to handle locks     */
+	uint8	prnopreempt;	/* preempt_disable nesting depth	*/
+	bool8	prpreemptpend;	/* A reschedule was held off by it	*/
+
+	/* Cold: bookkeeping rarely used while scheduling */
 	char	*prstkbase;	/* Base of run time stack		*/
 	uint32	prstklen;	/* Stack length in bytes		*/
 	char	prname[PNMLEN];	/* Process name				*/
 	sid32	prsem;		/* Semaphore on which process waits	*/
+	sid32	prmutex;	/* First mutex semaphore held, or -1	*/
 	pid32	prparent;	/* ID of the creating process		*/
-	umsg32	prmsg;		/* Message sent to this process		*/
-	bool8	prhasmsg;	/* Nonzero iff msg is valid		*/
+	umsg32	prmbox[MBOXLEN];/* Ring of messages sent to the process	*/
+	uint16	prmbhead;	/* Index of the oldest message		*/
+	uint16	prmbcount;	/* Number of messages in the ring	*/
+	bool8	prsendfail;	/* Recipient died while we were in	*/
+				/*   PR_SEND waiting for space		*/
+	pid32	prwaitfor;	/* Process a PR_SEND or PR_JOIN wait is	*/
+				/*   on (for deadlock detection)	*/
+	void	*prspinon;	/* sl_lock_t being spun on, or NULL	*/
+	uint32	prtryfail;	/* al_trylock failures since a success	*/
 	int16	prdesc[NDESC];	/* Device descriptors for process	*/
-	bool8   l_flag;     /* Flag to handle locks     */
-	uint32  runtime;    /* Number of milliseconds the process has been running   */
-	int16   pendingLockId;  /* Lock number on which the process is awaiting  */ 
-	//uint32  turnaroundtime; /* Turnaround time in milliseconds   */
-	//uint32  num_ctxsw;  /* number of context switch operations to the process   */ 
-	pi_lock_t *pendingLock;
-	pri16 priority;
+	void	*prentry;	/* Function the process started in	*/
+#ifdef	LOCKSTAT
+	uint64	lswaitstart;	/* When the current lock wait began	*/
+#endif
+	uint32  num_ctxsw;  /* number of context switch operations to the process   */ 
+	uint32  num_volsw;  /* switches away because the process blocked   */
+	uint32  num_invsw;  /* switches away while still runnable   */
+	uint64  cputime;    /* TSC cycles the process has been running   */
+	uint64  parktime;   /* TSC cycles spent parked on locks   */
+	uint64  swintime;   /* TSC when the process was last switched in   */
+	uint64  starttime;  /* TSC when the process was created (turnaround)   */
+} __attribute__ ((aligned (PRHOTSIZE)));
+
+/* Fail the build if the hot fields outgrow their cache line slice	*/
+
+typedef	char	prhot_ok[(__builtin_offsetof(struct procent, prstkbase)
+				<= PRHOTSIZE) ? 1 : -1];
+
+/* Queue of senders blocked on each process's full mailbox (0 until	*/
+/*   first needed, since no queue head has an index below NPROC)	*/
+
+extern	qid16	mbsendq[];
+
+/* Per-process accounting returned by getprocstats (TSC cycles)	*/
+
+struct	procstats {
+	uint64	ps_cputime;	/* Cycles spent running			*/
+	uint64	ps_parktime;	/* Cycles spent parked on locks		*/
+	uint64	ps_lifetime;	/* Cycles since the process was created	*/
+	uint32	ps_nctxsw;	/* Times the process was switched in	*/
+	uint32	ps_nvolsw;	/* Switches away because it blocked	*/
+	uint32	ps_ninvsw;	/* Switches away while still runnable	*/
 };
 
 /* Marker for the top of a process stack (used to help detect overflow)	*/
 #define	STACKMAGIC	0x0A0AAAA9
 
+/* Built with -DSTKPAINT, create paints each stack below the initial	*/
+/*   frame with this pattern, and the lowest word that no longer holds	*/
+/*   it marks the deepest the stack has grown.  Painting touches the	*/
+/*   whole stack on every create, so it is left out by default and	*/
+/*   stkuse then has nothing to report					*/
+#define	STKPATTERN	0xA5A5A5A5
+
+/* Peak stack use of exited processes, kept per entry point		*/
+
+#ifndef	NSTKSTAT
+#define	NSTKSTAT	16	/* Entry points tracked			*/
+#endif
+#define	STKSLACK	1024	/* Headroom added to a recommendation	*/
+
+struct	stkstat	{
+	void	*ssentry;	/* Entry point (create's funcaddr)	*/
+	char	ssname[PNMLEN];	/* Name of the first process seen	*/
+	uint32	sscount;	/* Processes that have exited		*/
+	uint32	sssize;		/* Largest stack size they were given	*/
+	uint32	sspeak;		/* Largest peak use among them		*/
+};
+
+extern	struct	stkstat	stkstattab[];
+extern	int32	nstkstat;	/* Entries of stkstattab in use		*/
+
+/* Stack size to suggest for a measured peak: a quarter more, plus	*/
+/*   STKSLACK for paths the measurement runs did not exercise		*/
+
+#define	stkrecommend(peak)	((uint32) roundmb((peak) + (peak) / 4 + STKSLACK))
+
 extern	struct	procent proctab[];
 extern	int32	prcount;	/* Currently active processes		*/
 extern	pid32	currpid;	/* Currently executing process		*/
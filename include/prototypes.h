@@ -5,7 +5,6 @@ extern	status	_82545EM_write_phy_reg(struct ethcblk *, uint32, uint16);
 
 /* in file active_lock.c */
 
-extern void    check_deadlock(pid32 curr_process, al_lock_t *l);
 extern syscall al_initlock(al_lock_t *l);
 extern syscall al_lock(al_lock_t *l);
 extern syscall al_unlock(al_lock_t *l);
@@ -28,6 +27,24 @@ extern	void	arp_hton(struct arppacket *);
 /* in file ascdate.c */
 extern	status	ascdate(uint32, char *);
 
+/* in file bench_create.c */
+extern	process	bench_create(int32, int32);
+
+/* in file bench_lock.c */
+extern	process	bench_lock(int32, int32, int32);
+
+/* in file bench_nproc.c */
+extern	process	bench_nproc(int32, int32);
+
+/* in file bench_pool.c */
+extern	process	bench_pool(int32, int32);
+
+/* in file bench_proctab.c */
+extern	process	bench_proctab(int32, int32);
+
+/* in file bench_sched.c */
+extern	process	bench_sched(int32, int32);
+
 /* in file bufinit.c */
 extern	status	bufinit(void);
 
@@ -39,6 +56,12 @@ extern	uint32	clkcount(void);
 
 /* in file clkhandler.c */
 extern	interrupt clkhandler(void);
+extern	bool8	clkadvance(uint32);
+
+/* in file clkidle.c */
+extern	void	clkidle(void);
+extern	uint32	clkperiodic(void);
+extern	void	clksync(void);
 
 /* in file clkinit.c */
 extern	void	clkinit(void);
@@ -54,10 +77,14 @@ extern	syscall	control(did32, int32, int32, int32);
 
 /* in file create.c */
 extern	pid32	create(void *, uint32, pri16, char *, uint32, ...);
+extern	void	freepid(pid32);
 
 /* in file ctxsw.S */
 extern	void	ctxsw(void *, void *);
 
+/* in file deadlock.c */
+extern	bool8	deadlock_check(pid32);
+
 /* in file dhcp.c */
 extern	uint32	getlocalip(void);
 
@@ -67,11 +94,17 @@ extern	status	dnslookup(char *, uint32 *);
 /* in file dot2ip.c */
 extern	status	dot2ip(char *, uint32 *);
 
+/* in file dwork.c */
+extern	syscall	dwork(void (*)(uint32), uint32);
+extern	syscall	dwstart(void);
+extern	void	dwrelease(pid32);
+
 /* in file getticks.c */
 extern	uint64	getticks(void);
 
-/* in file intutils.S */
-extern	intmask	disable(void);
+/* in file intutils.S (names in parentheses so the IRQTRACK macros	*/
+/*   in irqtrack.h leave these declarations alone)			*/
+extern	intmask	(disable)(void);
 
 /* in file intutils.S */
 extern	void	enable(void);
@@ -79,6 +112,11 @@ extern	void	enable(void);
 /* in file exit.c */
 extern	void	exit(void);
 
+/* in file klog.c */
+extern	syscall	klog(char *, ...);
+extern	void	klogflush(void);
+extern	syscall	klogstart(void);
+
 /* in file kprintf.c */
 extern int console_init(void);
 
@@ -116,6 +154,20 @@ extern  void exception(int32, int32*);
 /*  in file fork.c  */
 extern pid32 fork();
 
+/* in file fiber.c */
+extern	int32	fib_create(void (*)(void *), void *, uint32);
+extern	syscall	fib_yield(void);
+extern	void	fib_exit(void);
+extern	int32	fib_self(void);
+extern	syscall	fib_run(void);
+extern	void	fib_reclaim(pid32);
+extern	void	fib_mutex_init(struct fibmutex *);
+extern	syscall	fib_mutex_lock(struct fibmutex *);
+extern	syscall	fib_mutex_unlock(struct fibmutex *);
+
+/* in file fibswitch.S */
+extern	void	fibswitch(char **, char *);
+
 /* in file freebuf.c */
 extern	syscall	freebuf(char *);
 
@@ -142,6 +194,9 @@ extern	pid32	getpid(void);
 /* in file getprio.c */
 extern	syscall	getprio(pid32);
 
+/* in file getprocstats.c */
+extern	syscall	getprocstats(pid32, struct procstats *);
+
 /* in file getstk.c */
 extern	char	*getstk(uint32);
 
@@ -199,6 +254,12 @@ extern	void	ip_hton(struct netpacket *);
 extern	process	ipout(void);
 extern	status	ip_enqueue(struct netpacket *);
 
+/* in file irqtrack.c */
+extern	intmask	irqtrack_disable(char *, int32);
+extern	void	irqtrack_restore(intmask);
+extern	syscall	irqtrack_get(int32, struct irqtsite *);
+extern	void	irqtrack_reset(void);
+
 /* in file net.c */
 extern	void	net_init(void);
 extern	process	netin(void);
@@ -208,6 +269,10 @@ extern	void	eth_hton(struct netpacket *);
 extern	void	eth_ntoh(struct netpacket *);
 extern	uint16	getport(void);
 
+/* in file join.c */
+extern	syscall	join(pid32);
+extern	void	joinrelease(pid32);
+
 /* in file kill.c */
 extern	syscall	kill(pid32);
 
@@ -289,6 +354,14 @@ extern syscall setpark();
 extern syscall park();
 extern syscall unpark(pid32 processid);
 
+/* in file lockstat.c */
+extern	void	lockstat_register(lockstat_t *, int32, void *);
+extern	void	lockstat_contend(lockstat_t *);
+extern	void	lockstat_acquire(lockstat_t *);
+extern	void	lockstat_release(lockstat_t *);
+extern	syscall	lockstat_get(int32, void **, int32 *, lockstat_t *);
+extern	void	lockstat_reset(void);
+
 /* in file lpgetc.c */
 extern	devcall	lpgetc(struct dentry *);
 
@@ -307,6 +380,12 @@ extern	devcall	lpread(struct dentry *, char *, int32);
 /* in file lpwrite.c */
 extern	devcall	lpwrite(struct dentry *, char *, int32);
 
+/* in file mailbox.c */
+extern	void	mbdeliver(pid32, umsg32);
+extern	umsg32	mbtake(pid32);
+extern	status	mbwait(pid32);
+extern	void	mbrelease(pid32);
+
 /* in file mark.c */
 extern	void	markinit(void);
 extern	status	mark(int32 *);
@@ -481,6 +560,8 @@ extern	interrupt	sdmcdispatch(void);
 extern syscall sl_initlock(sl_lock_t *l);
 extern syscall sl_lock(sl_lock_t *l);
 extern syscall sl_unlock(sl_lock_t *l);
+extern intmask sl_lock_irqsave(sl_lock_t *l);
+extern syscall sl_unlock_irqrestore(sl_lock_t *l, intmask mask);
 
 /* in file read.c */
 extern	syscall	read(did32, char *, uint32);
@@ -491,9 +572,20 @@ extern	status	ready(pid32);
 /* in file ready.c  */
 extern	syscall  print_ready_list();
 
+/* in file readyq.c */
+extern	status	rq_insert(pid32, int32);
+extern	pid32	rq_remove(pid32);
+extern	pid32	rq_firstid(void);
+extern	int32	rq_firstkey(void);
+extern	pid32	rq_dequeue(void);
+extern	status	rq_reprio(pid32, int32);
+
 /* in file receive.c */
 extern	umsg32	receive(void);
 
+/* in file receiven.c */
+extern	int32	receiven(umsg32 *, int32);
+
 /* in file recvclr.c */
 extern	umsg32	recvclr(void);
 
@@ -503,9 +595,11 @@ extern	umsg32	recvtime(int32);
 /* in file resched.c */
 extern	void	resched(void);
 extern	status	resched_cntl(int32);
+extern	void	preempt_disable(void);
+extern	void	preempt_enable(void);
 
 /* in file intutils.S */
-extern	void	restore(intmask);
+extern	void	(restore)(intmask);
 
 /* in file resume.c */
 extern	pri16	resume(pid32);
@@ -557,16 +651,30 @@ extern	syscall	semcount(sid32);
 
 /* in file semcreate.c */
 extern	sid32	semcreate(int32);
+extern	sid32	semmutex(void);
 
 /* in file semdelete.c */
 extern	syscall	semdelete(sid32);
 
+/* in file semhold.c */
+extern	void	semhold(sid32, pid32);
+extern	void	semunhold(sid32);
+extern	void	semrelease(pid32);
+
 /* in file semreset.c */
 extern	syscall	semreset(sid32, int32);
 
 /* in file send.c */
 extern	syscall	send(pid32, umsg32);
 
+/* in file sendbuf.c */
+extern	syscall	sendbuf(pid32, char *);
+extern	char	*recvbuf(void);
+extern	void	bufreclaim(pid32);
+
+/* in file sendn.c */
+extern	int32	sendn(pid32, umsg32 *, int32);
+
 /* in file shell.c */
 extern 	process shell(did32);
 
@@ -592,6 +700,15 @@ extern	int32	outsw(int32, int32, int32);
 extern	int32	lidt(void);
 extern	int32	cpuid(void);
 
+/* in file stkcache.c */
+extern	char	*stkcget(uint32);
+extern	void	stkcput(char *, uint32);
+extern	void	stkcflush(void);
+
+/* in file stkuse.c */
+extern	int32	stkuse(pid32);
+extern	void	stkrecord(pid32);
+
 /* in file suspend.c */
 extern	syscall	suspend(pid32);
 
@@ -631,6 +748,14 @@ extern	devcall	ttyread(struct dentry *, char *, int32);
 /* in file ttywrite.c */
 extern	devcall	ttywrite(struct dentry *, char *, int32);
 
+/* in file twheel.c */
+extern	void	twinit(void);
+extern	status	tw_insert(pid32, int32);
+extern	status	tw_cancel(pid32);
+extern	bool8	tw_tick(void);
+extern	pid32	tw_expire(void);
+extern	uint32	tw_idle(uint32);
+
 /* in file udp.c */
 extern	void	udp_init(void);
 extern	void	udp_in(struct netpacket *);
@@ -644,6 +769,13 @@ extern	status	udp_release(uid32);
 extern	void	udp_ntoh(struct netpacket *);
 extern	void	udp_hton(struct netpacket *);
 
+/* in file udelay.c */
+extern	void	delaycal(void);
+extern	uint64	usecs2ticks(uint32);
+extern	void	udelay(uint32);
+extern	void	ndelay(uint32);
+extern	void	spin_until(uint64);
+
 /* in file unsleep.c */
 extern	syscall	unsleep(pid32);
 
@@ -656,12 +788,27 @@ extern	syscall	wait(sid32);
 /* in file wakeup.c */
 extern	void	wakeup(void);
 
+/* in file wpool.c */
+extern	int32	pool_create(int32, pri16);
+extern	syscall	pool_submit(int32, void (*)(void *), void *);
+extern	syscall	pool_wait(int32);
+extern	syscall	pool_delete(int32);
+
+/* in file watchdog.c */
+extern	void	wdsample(void);
+extern	syscall	wdstart(void);
+
 /* in file write.c */
 extern	syscall	write(did32, char *, uint32);
 
 /* in file xdone.c */
 extern	void	xdone(void);
 
+/* in file xtrace.c */
+extern	void	xtrace_rec(uint16, pid32, uint32);
+extern	void	xtracedump(void);
+extern	void	xtraceclear(void);
+
 /* in file yield.c */
 extern	syscall	yield(void);
 
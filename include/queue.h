@@ -3,11 +3,17 @@
 /* Queue structure declarations, constants, and inline functions	*/
 
 /* Default # of queue entries: 1 per process plus 2 for ready list plus	*/
-/*			2 for sleep list plus 2 per semaphore		*/
+/*			2 for sleep list plus 2 per semaphore plus	*/
+/*			2 per process for mailbox senders		*/
 #ifndef NQENT
-#define NQENT	(NPROC + 4 + NSEM + NSEM + 2 * NLOCKS + 2 * NALOCKS + 2 * NPILOCKS)
+#define NQENT	(NPROC + 4 + NSEM + NSEM + 2 * NLOCKS + 2 * NALOCKS + 2 * NPILOCKS \
+		 + 2 * NPROC)
 #endif
 
+/* Queue indexes are qid16, so the whole table must be addressable	*/
+
+typedef	char	qtabsize_ok[(NQENT <= 32767) ? 1 : -1];
+
 #define	EMPTY	(-1)		/* Null value for qnext or qprev index	*/
 #define	MAXKEY	0x7FFFFFFF	/* Max key that can be stored in queue	*/
 #define	MINKEY	0x80000000	/* Min key that can be stored in queue	*/
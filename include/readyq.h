@@ -0,0 +1,48 @@
+/* readyq.h - rqindex, rqtest, rqbsr */
+
+/* The ready list is kept as one FIFO per priority level plus a three-	*/
+/*   level bitmap of nonempty levels, so that insert, remove, and	*/
+/*   finding the highest priority ready process are all constant time	*/
+
+#ifndef NRQPRIO
+#define	NRQPRIO		32768	/* Distinct priority levels (multiple	*/
+#endif				/*   of 32, at most 32768)		*/
+
+#define	RQWBITS		32	/* Bits in one bitmap word		*/
+#define	RQNWORD		(NRQPRIO / RQWBITS)	/* Leaf bitmap words	*/
+#define	RQNSUM		((RQNWORD + RQWBITS - 1) / RQWBITS)
+					/* Summary words over the leaves*/
+
+struct	rqinfo	{		/* Ready list state			*/
+	uint32	rqtop;		/* Bit i set iff rqsum[i] is nonzero	*/
+	uint32	rqsum[RQNSUM];	/* Bit j set iff rqbits[32*i+j] nonzero	*/
+	uint32	rqbits[RQNWORD];/* Bit k set iff that priority level	*/
+				/*   has at least one ready process	*/
+	pid32	rqhead[NRQPRIO];/* First process at each level; the	*/
+				/*   level is a circular list threaded	*/
+				/*   through queuetab qnext/qprev	*/
+	int32	rqcount;	/* Number of processes on the list	*/
+};
+
+extern	struct	rqinfo	readyq;
+
+/* Map a process priority onto a level; priorities above the top	*/
+/*   level share it (FIFO among themselves)				*/
+
+#define	rqindex(k)	( ((int32)(k) < 0) ? 0 :			\
+			  ((int32)(k) >= NRQPRIO) ? NRQPRIO - 1 : (int32)(k) )
+
+#define	rqtest(p)	(readyq.rqbits[(p) >> 5] & (1 << ((p) & 0x1f)))
+#define	rqisempty()	(readyq.rqtop == 0)
+
+/* Index of the most significant set bit in a nonzero word (x86 bsr)	*/
+
+static	inline	uint32	rqbsr(
+	  uint32	w		/* Word to scan (nonzero)	*/
+	)
+{
+	uint32	r;
+
+	asm ("bsrl %1, %0" : "=r" (r) : "rm" (w));
+	return r;
+}
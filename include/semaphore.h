@@ -0,0 +1,29 @@
+/* semaphore.h - isbadsem */
+
+#ifndef	NSEM
+#define	NSEM		120	/* Number of semaphores, if not defined	*/
+#endif
+
+/* Semaphore state definitions */
+
+#define	S_FREE	0		/* Semaphore table entry is available	*/
+#define	S_USED	1		/* Semaphore table entry is in use	*/
+
+/* Semaphore table entry.  A semaphore created with semmutex is a	*/
+/*   mutex: the process holding its unit is tracked, and each process	*/
+/*   keeps a list of the mutexes it holds, so deadlock detection can	*/
+/*   follow waiters to the holder and kill can forget a dead holder	*/
+
+struct	sentry	{
+	byte	sstate;		/* Whether entry is S_FREE or S_USED	*/
+	bool8	smutex;		/* Used as a mutex: sholder is valid	*/
+	int32	scount;		/* Count for the semaphore		*/
+	qid16	squeue;		/* Queue of processes that are waiting	*/
+				/*     on the semaphore			*/
+	pid32	sholder;	/* Process holding a mutex, or -1	*/
+	sid32	snextheld;	/* Next mutex held by sholder, or -1	*/
+};
+
+extern	struct	sentry semtab[];
+
+#define	isbadsem(s)	((int32)(s) < 0 || (s) >= NSEM)
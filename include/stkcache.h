@@ -0,0 +1,22 @@
+/* stkcache.h - stack cache configuration */
+
+/* Stacks of processes that exit are kept for reuse by create instead	*/
+/*   of going back to the memory allocator.  The cache has STKCNCLASS	*/
+/*   size classes (one per distinct stack size seen), each holding up	*/
+/*   to STKCDEPTH stacks, and never holds more than STKCMAXBYTES in	*/
+/*   total.  Build with STKCDEPTH set to 0 to disable it.		*/
+
+#ifndef	STKCNCLASS
+#define	STKCNCLASS	4		/* Distinct stack sizes cached	*/
+#endif
+
+#ifndef	STKCDEPTH
+#define	STKCDEPTH	4		/* Stacks kept per size class	*/
+#endif
+
+#ifndef	STKCMAXBYTES
+#define	STKCMAXBYTES	(512 * 1024)	/* Upper bound on cached memory	*/
+#endif
+
+extern	uint32	stkchits;		/* Creates served from cache	*/
+extern	uint32	stkcmisses;		/* Creates that called getstk	*/
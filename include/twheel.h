@@ -0,0 +1,36 @@
+/* twheel.h - twhead, twqueued */
+
+/* Hierarchical timing wheel that holds one timer per process (sleep,	*/
+/*   timed receive).  Level 0 has one slot per tick; each higher level	*/
+/*   has slots that span a whole turn of the level below it and are	*/
+/*   cascaded down as time reaches them.  Like queuetab, entries 0 to	*/
+/*   NPROC-1 belong to processes and the remaining entries are list	*/
+/*   heads, so every list is circular and doubly linked.		*/
+
+#define	TWL0BITS	8		/* Level 0: 256 one-tick slots	*/
+#define	TWLNBITS	6		/* Levels 1-4: 64 slots each	*/
+#define	TWL0SIZE	(1 << TWL0BITS)
+#define	TWLNSIZE	(1 << TWLNBITS)
+#define	TWNLEVEL	5		/* Covers the full 32-bit range	*/
+#define	TWNSLOT		(TWL0SIZE + (TWNLEVEL - 1) * TWLNSIZE)
+
+#define	TWPENDING	TWNSLOT		/* Cascaded, not yet re-placed	*/
+#define	TWEXPIRED	(TWNSLOT + 1)	/* Due, waiting to be awakened	*/
+#define	TWNENT		(NPROC + TWNSLOT + 2)
+
+#ifndef	TWBUDGET
+#define	TWBUDGET	32		/* Entries moved or awakened	*/
+#endif					/*   per tick at most		*/
+
+struct	twent	{		/* One per process plus one per list	*/
+	uint32	twexp;		/* Tick at which the timer expires	*/
+	int32	twnext;		/* Next entry, or EMPTY if not queued	*/
+	int32	twprev;		/* Previous entry			*/
+};
+
+extern	struct	twent	twtab[];
+extern	uint32	twnow;		/* Ticks processed by the wheel		*/
+
+#define	twhead(s)	(NPROC + (s))	/* Entry index of a list head	*/
+#define	twqueued(p)	(twtab[(p)].twnext != EMPTY)
+#define	twnonempty(s)	(twtab[twhead(s)].twnext != twhead(s))
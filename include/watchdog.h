@@ -0,0 +1,27 @@
+/* watchdog.h - lock watchdog configuration */
+
+/* The watchdog process samples lock state every WDPERIOD ms: the	*/
+/*   holders in locks[] and each process's piheld list, the waits in	*/
+/*   pendingLockId, pendingLock, and prspinon, and the al_trylock	*/
+/*   failure streak in prtryfail.  A hold or wait seen unchanged for	*/
+/*   longer than its limit, or a streak past WDTRYFAIL, is reported	*/
+/*   once through klog.  Because it only samples, a lock released and	*/
+/*   taken again by the same process between two samples looks like	*/
+/*   one long hold.							*/
+
+#ifndef	WDPERIOD
+#define	WDPERIOD	100		/* ms between samples		*/
+#endif
+#ifndef	WDHOLDMS
+#define	WDHOLDMS	1000		/* Longest hold before a report	*/
+#endif
+#ifndef	WDWAITMS
+#define	WDWAITMS	1000		/* Longest wait before a report	*/
+#endif
+#ifndef	WDTRYFAIL
+#define	WDTRYFAIL	1000		/* al_trylock failures in a row	*/
+#endif
+
+#define	WDPRIO		500		/* Above the processes watched,	*/
+					/*   so spinners cannot starve it*/
+#define	WDSTK		4096		/* Stack size of the watchdog	*/
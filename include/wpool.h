@@ -0,0 +1,47 @@
+/* wpool.h - isbadwpool */
+
+/* A worker pool is a fixed set of processes that take tasks (a	*/
+/*   function and one argument) from a bounded ring and run them, so	*/
+/*   short jobs avoid the cost of create and kill.  Idle workers wait	*/
+/*   on a semaphore that counts queued tasks.				*/
+
+#ifndef	NWPOOL
+#define	NWPOOL		4		/* Number of worker pools	*/
+#endif
+
+#ifndef	WPMAXWORK
+#define	WPMAXWORK	16		/* Workers in one pool at most	*/
+#endif
+
+#ifndef	WPQLEN
+#define	WPQLEN		64		/* Tasks that can be queued	*/
+#endif
+
+#define	WPSTK		8192		/* Stack size of each worker	*/
+
+#define	WP_FREE		0		/* Pool table entry is unused	*/
+#define	WP_USED		1		/* Pool table entry is in use	*/
+
+struct	wptask	{			/* One queued unit of work	*/
+	void	(*wtfunc)(void *);	/* Function to run		*/
+	void	*wtarg;			/* Argument passed to it	*/
+};
+
+struct	wpentry	{			/* Entry in the pool table	*/
+	byte	wpstate;		/* WP_FREE or WP_USED		*/
+	int32	wpnwork;		/* Number of workers		*/
+	pid32	wpwork[WPMAXWORK];	/* IDs of the workers		*/
+	struct	wptask	wpq[WPQLEN];	/* Ring of queued tasks		*/
+	int32	wphead;			/* Index of the oldest task	*/
+	int32	wpcount;		/* Tasks in the ring		*/
+	int32	wppending;		/* Tasks queued or running	*/
+	int32	wpnwait;		/* Processes in pool_wait	*/
+	sid32	wptasks;		/* Counts tasks in the ring	*/
+	sid32	wpslots;		/* Counts free slots in the ring*/
+	sid32	wpdone;			/* pool_wait callers block here	*/
+};
+
+extern	struct	wpentry	wptab[];
+
+#define	isbadwpool(p)	(((int32)(p) < 0) || ((p) >= NWPOOL) || \
+			 (wptab[(p)].wpstate == WP_FREE))
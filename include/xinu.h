@@ -5,12 +5,22 @@
 #include <conf.h>
 #include <process.h>
 #include <queue.h>
+#include <readyq.h>
 #include <resched.h>
 #include <mark.h>
 #include <semaphore.h>
+#include <wpool.h>
+#include <fiber.h>
 #include <memory.h>
+#include <stkcache.h>
 #include <bufpool.h>
 #include <clock.h>
+#include <klog.h>
+#include <watchdog.h>
+#include <dwork.h>
+#include <xtrace.h>
+#include <irqtrack.h>
+#include <twheel.h>
 #include <ports.h>
 #include <io.h>
 #include <uart.h>
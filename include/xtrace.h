@@ -0,0 +1,43 @@
+/* xtrace.h - xtrace */
+
+/* Binary event trace of scheduling and locking, built with -DXTRACE.	*/
+/*   Each record is a TSC timestamp, an event type, the process it	*/
+/*   concerns, and one argument; xtracedump prints the buffer over the	*/
+/*   console as hex for tools/xtrace2json.py.  Without XTRACE every	*/
+/*   hook compiles to nothing.						*/
+
+#define	XT_SWITCH	1	/* pid gives up the CPU to arg		*/
+#define	XT_PARK		2	/* pid parks, arg is the lock (or 0)	*/
+#define	XT_UNPARK	3	/* pid is made ready by a lock release	*/
+#define	XT_ACQUIRE	4	/* pid holds lock arg			*/
+#define	XT_CONTEND	5	/* pid found lock arg held		*/
+#define	XT_RELEASE	6	/* pid gives up lock arg		*/
+#define	XT_PRIO		7	/* pid priority: arg = old << 16 | new	*/
+
+/* Lock flavor, or'ed into the type of lock events */
+
+#define	XTF_LOCK	0x0000	/* lock_t				*/
+#define	XTF_AL		0x0100	/* al_lock_t				*/
+#define	XTF_PI		0x0200	/* pi_lock_t				*/
+#define	XTF_SL		0x0300	/* sl_lock_t				*/
+
+struct	xtrec	{		/* One trace record (16 bytes)		*/
+	uint64	xttsc;		/* TSC when the event happened		*/
+	uint16	xttype;		/* XT_* event, plus XTF_* flavor	*/
+	uint16	xtpid;		/* Process the event concerns		*/
+	uint32	xtarg;		/* Lock address, new pid, or priorities	*/
+};
+
+#ifdef	XTRACE
+
+#ifndef	XTRACELEN
+#define	XTRACELEN	8192	/* Records kept; the oldest are		*/
+#endif				/*   overwritten when it fills		*/
+
+#define	xtrace(t, p, a)	xtrace_rec((t), (p), (uint32)(a))
+
+#else
+
+#define	xtrace(t, p, a)	((void) 0)
+
+#endif
@@ -0,0 +1,64 @@
+/* xsh_irqtrack.c - xsh_irqtrack */
+
+#include <xinu.h>
+#include <stdio.h>
+#include <string.h>
+
+/*------------------------------------------------------------------------
+ * xsh_irqtrack - shell command to print the disable() call sites that
+ *		  kept interrupts off longest, or to reset them
+ *------------------------------------------------------------------------
+ */
+shellcmd xsh_irqtrack(int nargs, char *args[])
+{
+#ifdef	IRQTRACK
+	struct	irqtsite its;		/* copy of one site's counters	*/
+	int32	i;			/* index into the site table	*/
+	uint32	avg;			/* mean cycles per window	*/
+#endif
+
+	/* For argument '--help', emit help about the 'irqtrack' command	*/
+
+	if (nargs == 2 && strncmp(args[1], "--help", 7) == 0) {
+		printf("Use: %s [-r]\n\n", args[0]);
+		printf("Description:\n");
+		printf("\tDisplays the disable() call sites with the longest\n");
+		printf("\tinterrupts-off windows, in cycles\n");
+		printf("Options:\n");
+		printf("\t-r\t reset all sites\n");
+		printf("\t--help\t display this help and exit\n");
+		return 0;
+	}
+
+	/* Check for valid number of arguments */
+
+	if (nargs > 2 || (nargs == 2 && strncmp(args[1], "-r", 3) != 0)) {
+		fprintf(stderr, "%s: invalid arguments\n", args[0]);
+		fprintf(stderr, "Try '%s --help' for more information\n",
+				args[0]);
+		return 1;
+	}
+
+#ifndef	IRQTRACK
+	fprintf(stderr, "%s: kernel not built with IRQTRACK\n", args[0]);
+	return 1;
+#else
+	if (nargs == 2) {
+		irqtrack_reset();
+		return 0;
+	}
+
+	printf("%-24s %5s %8s %10s %10s\n", "File", "Line", "Windows",
+		   "Avg", "Max");
+	printf("%-24s %5s %8s %10s %10s\n", "------------------------",
+		   "-----", "--------", "----------", "----------");
+
+	for (i = 0; irqtrack_get(i, &its) == OK; i++) {
+		avg = (its.itcount == 0) ? 0 :
+				(uint32)(its.ittotal / its.itcount);
+		printf("%-24s %5d %8u %10u %10u\n", its.itfile, its.itline,
+			its.itcount, avg, (uint32)its.itmax);
+	}
+	return 0;
+#endif
+}
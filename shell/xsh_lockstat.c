@@ -0,0 +1,78 @@
+/* xsh_lockstat.c - xsh_lockstat */
+
+#include <xinu.h>
+#include <stdio.h>
+#include <string.h>
+
+/*------------------------------------------------------------------------
+ * xsh_lockstat - shell command to print the contention statistics of
+ *		  every initialized lock, or to reset them
+ *------------------------------------------------------------------------
+ */
+shellcmd xsh_lockstat(int nargs, char *args[])
+{
+#ifdef	LOCKSTAT
+	static	char	*kindname[] = { "spin", "lock", "active", "pi" };
+	lockstat_t	ls;		/* copy of one lock's counters	*/
+	void	*lk;			/* address of the lock		*/
+	int32	kind;			/* flavor of the lock		*/
+	int32	i, b;			/* index into registry, bucket	*/
+	uint32	avgwait;		/* mean cycles per contended wait*/
+#endif
+
+	/* For argument '--help', emit help about the 'lockstat' command	*/
+
+	if (nargs == 2 && strncmp(args[1], "--help", 7) == 0) {
+		printf("Use: %s [-r]\n\n", args[0]);
+		printf("Description:\n");
+		printf("\tDisplays acquisitions, contention, wait times and\n");
+		printf("\ta hold-time histogram for each lock\n");
+		printf("Options:\n");
+		printf("\t-r\t reset all counters\n");
+		printf("\t--help\t display this help and exit\n");
+		return 0;
+	}
+
+	/* Check for valid number of arguments */
+
+	if (nargs > 2 || (nargs == 2 && strncmp(args[1], "-r", 3) != 0)) {
+		fprintf(stderr, "%s: invalid arguments\n", args[0]);
+		fprintf(stderr, "Try '%s --help' for more information\n",
+				args[0]);
+		return 1;
+	}
+
+#ifndef	LOCKSTAT
+	fprintf(stderr, "%s: kernel not built with LOCKSTAT\n", args[0]);
+	return 1;
+#else
+	if (nargs == 2) {
+		lockstat_reset();
+		return 0;
+	}
+
+	/* Print header; holds are bucketed by powers of four of cycles	*/
+	/*   starting below 1K						*/
+
+	printf("%-10s %-6s %8s %8s %8s %8s %10s %10s  %s\n",
+		   "Lock", "Kind", "Acquires", "Contend", "Spins", "Backoffs",
+		   "Avg Wait", "Max Wait", "Hold <1K,4K,16K,...");
+	printf("%-10s %-6s %8s %8s %8s %8s %10s %10s  %s\n",
+		   "----------", "------", "--------", "--------", "--------",
+		   "--------", "----------", "----------",
+		   "-------------------");
+
+	for (i = 0; lockstat_get(i, &lk, &kind, &ls) == OK; i++) {
+		avgwait = (ls.contended == 0) ? 0 :
+				(uint32)(ls.waittotal / ls.contended);
+		printf("0x%08x %-6s %8u %8u %8u %8u %10u %10u ", (uint32)lk,
+			kindname[kind], ls.acquires, ls.contended, ls.spins,
+			ls.backoffs, avgwait, (uint32)ls.waitmax);
+		for (b = 0; b < LSNBUCKET; b++) {
+			printf(" %u", ls.holdhist[b]);
+		}
+		printf("\n");
+	}
+	return 0;
+#endif
+}
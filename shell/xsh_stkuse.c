@@ -0,0 +1,84 @@
+/* xsh_stkuse.c - xsh_stkuse */
+
+#include <xinu.h>
+#include <stdio.h>
+#include <string.h>
+
+/*------------------------------------------------------------------------
+ * xsh_stkuse - shell command to print the peak stack use of each live
+ *		process and, per entry point of exited processes, the
+ *		largest peak seen and a recommended stack size
+ *------------------------------------------------------------------------
+ */
+shellcmd xsh_stkuse(int nargs, char *args[])
+{
+#ifdef	STKPAINT
+	struct	procent	*prptr;		/* pointer to process		*/
+	struct	stkstat	*ssptr;		/* pointer to entry point stats	*/
+	int32	i;			/* index into tables		*/
+	int32	peak;			/* peak use of a live process	*/
+#endif
+
+	/* For argument '--help', emit help about the 'stkuse' command	*/
+
+	if (nargs == 2 && strncmp(args[1], "--help", 7) == 0) {
+		printf("Use: %s\n\n", args[0]);
+		printf("Description:\n");
+		printf("\tDisplays the peak stack use of each process\n");
+		printf("\tand the recommended stack size per entry point\n");
+		printf("Options:\n");
+		printf("\t--help\t display this help and exit\n");
+		return 0;
+	}
+
+	/* Check for valid number of arguments */
+
+	if (nargs > 1) {
+		fprintf(stderr, "%s: too many arguments\n", args[0]);
+		fprintf(stderr, "Try '%s --help' for more information\n",
+				args[0]);
+		return 1;
+	}
+
+#ifndef	STKPAINT
+	fprintf(stderr, "%s: kernel not built with STKPAINT\n", args[0]);
+	return 1;
+#else
+	/* Print header for items from the process table */
+
+	printf("%3s %-16s %10s %10s %10s\n",
+		   "Pid", "Name", "Stack Size", "Peak Use", "Recommend");
+
+	printf("%3s %-16s %10s %10s %10s\n",
+		   "---", "----------------", "----------", "----------",
+		   "----------");
+
+	for (i = 1; i < NPROC; i++) {
+		prptr = &proctab[i];
+		if ((peak = stkuse(i)) == SYSERR) {
+			continue;	/* slot free or null process	*/
+		}
+		printf("%3d %-16s %10d %10d %10d\n", i, prptr->prname,
+			prptr->prstklen, peak, stkrecommend(peak));
+	}
+
+	/* Print the statistics gathered as processes exited */
+
+	if (nstkstat == 0) {
+		return 0;
+	}
+	printf("\n%-16s %6s %10s %10s %10s\n",
+		   "Entry (name)", "Exited", "Stack Size", "Peak Use",
+		   "Recommend");
+	printf("%-16s %6s %10s %10s %10s\n",
+		   "----------------", "------", "----------", "----------",
+		   "----------");
+	for (i = 0; i < nstkstat; i++) {
+		ssptr = &stkstattab[i];
+		printf("%-16s %6d %10d %10d %10d\n", ssptr->ssname,
+			ssptr->sscount, ssptr->sssize, ssptr->sspeak,
+			stkrecommend(ssptr->sspeak));
+	}
+	return 0;
+#endif
+}
@@ -0,0 +1 @@
+/* conf.h - the host simulation has no devices */
@@ -0,0 +1,60 @@
+/* kernel.h - types and constants for the host simulation build */
+
+/* The same type names and constants as the target kernel.h, with	*/
+/*   widths that hold on an LP64 Linux host				*/
+
+typedef	unsigned char	byte;
+typedef	unsigned char	uint8;
+typedef	int		int32;
+typedef	short		int16;
+typedef	char		int8;
+typedef	unsigned int	uint32;
+typedef	unsigned short	uint16;
+typedef	unsigned long long uint64;
+typedef	long long	int64;
+
+typedef	int32	sid32;		/* semaphore ID				*/
+typedef	int16	qid16;		/* queue ID				*/
+typedef	int32	pid32;		/* process ID				*/
+typedef	int32	did32;		/* device ID				*/
+typedef	int16	pri16;		/* process priority			*/
+typedef	uint32	umsg32;		/* message passed among processes	*/
+typedef	int32	bpid32;		/* buffer pool ID			*/
+typedef	byte	bool8;		/* Boolean type				*/
+typedef	uint32	intmask;	/* saved interrupt mask			*/
+typedef	int32	ibid32;		/* index block ID (used in file system)	*/
+typedef	int32	dbid32;		/* data block ID (used in file system)	*/
+typedef	int32	uid32;		/* ID for UDP table descriptor		*/
+
+typedef	int32	syscall;	/* system call declaration		*/
+typedef	int32	devcall;	/* device call declaration		*/
+typedef	int32	shellcmd;	/* shell command declaration		*/
+typedef	int32	process;	/* top-level function of a process	*/
+typedef	void	interrupt;	/* interrupt procedure			*/
+typedef	int32	status;		/* returned status value (OK/SYSERR)	*/
+
+#define local	static		/* Local procedure or variable declar.	*/
+
+#define	NULLCH	'\0'		/* null character			*/
+#define	NULL	0		/* null pointer				*/
+#define	TRUE	1		/* Boolean constants			*/
+#define	FALSE	0
+
+#define	OK	( 1)		/* normal system call return		*/
+#define	SYSERR	(-1)		/* system call failed			*/
+#define	EOF	(-2)		/* End-of-file (usually from read)	*/
+#define	TIMEOUT	(-3)		/* system call timed out		*/
+
+#define	QUANTUM	2		/* time slice in milliseconds		*/
+#define	MINSTK	400		/* minimum stack size in bytes		*/
+#define	CONSOLE	0		/* console device			*/
+#define	NSEM	120		/* semaphores (sizes NQENT)		*/
+
+/* Structures the prototypes mention only by pointer */
+
+struct	dentry;	struct	ethcblk; struct	arppacket; struct netpacket;
+struct	lfiblk;	struct	lflcblk; struct	lfdbfree; struct lfdir;
+struct	ptentry; struct	rd_msg_hdr; struct rdscblk; struct rdqnode;
+struct	rdcnode; struct	ttycblk; struct	uart_csreg; struct rf_msg_hdr;
+
+extern	int	kprintf(const char *, ...);
@@ -0,0 +1,8 @@
+/* memory.h - roundmb, truncmb */
+
+#define	PAGE_SIZE	4096
+
+/* Round and truncate to a multiple of 8 bytes, pointer-width safe	*/
+
+#define	roundmb(x)	(char *)( (7 + (unsigned long)(x)) & (~7UL) )
+#define	truncmb(x)	(char *)( ((unsigned long)(x)) & (~7UL) )
@@ -0,0 +1,59 @@
+/* sim.h - simulated machine state for the host build */
+
+/* Time is a virtual cycle counter that only moves when the kernel or	*/
+/*   a test calls simstep: every test_and_set, queue operation,	*/
+/*   disable, restore, and klog costs SIMCOST cycles plus a jitter	*/
+/*   drawn from a seeded generator, and a clock interrupt arrives	*/
+/*   every SIMCYCMS cycles, or as soon as interrupts are enabled	*/
+/*   again.  A run is therefore a pure function of its seed.		*/
+/*									*/
+/* Every step taken with interrupts enabled is also a preemption	*/
+/*   point, numbered from 0 in the order the run reaches them.  A	*/
+/*   schedule is an ascending list of point numbers; at each one the	*/
+/*   running process is preempted as if its time slice had ended.	*/
+/*   A run is a pure function of its seed and schedule, so a failure	*/
+/*   found by exploring schedules replays exactly.			*/
+
+#define	SIMCYCMS	10000		/* Virtual cycles per clock tick*/
+#define	SIMCOST		20		/* Cycles per simulated step	*/
+#define	SIMJITTER	64		/* Random cycles added per step	*/
+#define	SIMLIMIT	(2000ULL * SIMCYCMS)	/* Run length cap	*/
+
+#define	SIM_DONE	0		/* Every process exited		*/
+#define	SIM_STUCK	1		/* Processes left, none can run	*/
+#define	SIM_TIMEOUT	2		/* Virtual time limit reached	*/
+
+struct	simstate {
+	uint64	clock;			/* Virtual cycle counter	*/
+	uint64	nexttick;		/* When the next tick is due	*/
+	uint64	steps;			/* Steps taken			*/
+	uint32	seed;			/* Jitter generator state	*/
+	bool8	intr;			/* Interrupts enabled		*/
+	int32	result;			/* SIM_DONE, etc.		*/
+	int32	verbose;		/* Print klog output		*/
+	int32	ndeadlock;		/* deadlock_detected reports	*/
+	uint32	nswitch;		/* Context switches		*/
+	uint32	npoint;			/* Preemption points passed	*/
+	const uint32 *sched;		/* Points to preempt at		*/
+	int32	nsched;			/* Entries in sched		*/
+	int32	nextsched;		/* Next entry to reach		*/
+};
+
+extern	struct	simstate sim;
+
+/* A test: main runs as the first process, check inspects the state	*/
+/*   left when the run ends and returns TRUE if it is acceptable	*/
+
+struct	simtest	{
+	char	*stname;		/* Name used on the command line*/
+	void	*stmain;		/* First process		*/
+	bool8	(*stcheck)(void);	/* Judge the run		*/
+};
+
+extern	struct	simtest	simtesttab[];
+
+/* in file simkernel.c */
+extern	void	simstep(uint32);
+extern	uint32	simrand(void);
+extern	void	simwork(uint32);
+extern	int32	simrun(void *, uint32, const uint32 *, int32, int32);
@@ -0,0 +1,30 @@
+/* simhost.h - interface between the simulated kernel and the host */
+
+/* Only plain C types appear here: this header is shared by simhost.c,	*/
+/*   which is built against libc, and the kernel-side sources, which	*/
+/*   are built against the kernel headers and never see libc		*/
+
+#define	SIMSTK		(64 * 1024)	/* Host stack of each process	*/
+
+/* Contexts (simhost.c) */
+
+extern	void	*sim_ctxnew(void (*)(void));	/* NULL if out of memory*/
+extern	void	sim_ctxfree(void *);
+extern	void	*sim_ctxhost(void);		/* Context of main()	*/
+extern	void	sim_ctxswap(void *, void *);	/* Save first, run 2nd	*/
+
+/* Output (simhost.c) */
+
+extern	int	sim_vprintf(const char *, __builtin_va_list);
+
+/* Memory routines under the names simnames.h gives them (simhost.c) */
+
+extern	void	*xmemset(void *, const int, int);
+extern	void	*xmemcpy(void *, const void *, int);
+
+/* Tests (simtest.c, simkernel.c); sim_runtest returns 0 when the run	*/
+/*   passed and stores the number of preemption points it reached	*/
+
+extern	const char *sim_testname(int);		/* NULL past the last	*/
+extern	int	sim_runtest(int, unsigned int, const unsigned int *, int,
+			int, unsigned int *);
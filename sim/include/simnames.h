@@ -0,0 +1,11 @@
+/* simnames.h - keep kernel names that the C library also defines apart */
+
+/* Forced ahead of every kernel-side source in the simulation build, so	*/
+/*   the objects never define or call the libc function of the same	*/
+/*   name; the host side supplies the memory routines under these names	*/
+
+#define	sleep		xsleep
+#define	kill		xkill
+#define	getpid		xgetpid
+#define	memset		xmemset
+#define	memcpy		xmemcpy
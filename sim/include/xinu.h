@@ -0,0 +1,25 @@
+/* xinu.h - include the kernel headers the host simulation needs */
+
+#include <kernel.h>
+#include <lock.h>
+#include <conf.h>
+#include <process.h>
+#include <queue.h>
+#include <readyq.h>
+#include <resched.h>
+#include <semaphore.h>
+#include <memory.h>
+#include <clock.h>
+#include <klog.h>
+#include <watchdog.h>
+#include <dwork.h>
+#include <xtrace.h>
+#include <irqtrack.h>
+#include <twheel.h>
+#include <wpool.h>
+#include <fiber.h>
+#include <stkcache.h>
+#include <bufpool.h>
+#include <prototypes.h>
+#include <sim.h>
+#include <simhost.h>
@@ -0,0 +1,442 @@
+/* simhost.c - host side of the simulation: contexts, output, and the	*/
+/*	       command line driver, including the schedule explorer	*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <ucontext.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include "simhost.h"
+
+struct	simctx	{			/* One simulated process	*/
+	ucontext_t	uc;		/* Saved registers		*/
+	void		*stack;		/* Its host stack		*/
+};
+
+#define	SIMWALL		10		/* Seconds a child may run	*/
+#define	SIMMAXPRE	32		/* Longest schedule		*/
+#define	SIMBUDGET	10000		/* Default runs per exploration	*/
+
+static	struct	simctx	hostctx;	/* Context of main()		*/
+static	unsigned int	*childpts;	/* A child's preemption points,	*/
+					/*   in memory shared with us	*/
+
+static	int	exruns;			/* Runs made by an exploration	*/
+static	int	exfailed;		/* ... and how many failed	*/
+static	unsigned int	exbad[SIMMAXPRE];	/* First failing schedule	*/
+static	int	nexbad;
+
+void	*sim_ctxnew(void (*entry)(void))
+{
+	struct	simctx	*c;
+
+	if ((c = calloc(1, sizeof(*c))) == NULL) {
+		return NULL;
+	}
+	if ((c->stack = malloc(SIMSTK)) == NULL) {
+		free(c);
+		return NULL;
+	}
+	getcontext(&c->uc);
+	c->uc.uc_stack.ss_sp = c->stack;
+	c->uc.uc_stack.ss_size = SIMSTK;
+	c->uc.uc_link = NULL;
+	makecontext(&c->uc, entry, 0);
+	return c;
+}
+
+void	sim_ctxfree(void *ctx)
+{
+	struct	simctx	*c = ctx;
+
+	free(c->stack);
+	free(c);
+}
+
+void	*sim_ctxhost(void)
+{
+	return &hostctx;
+}
+
+void	sim_ctxswap(void *from, void *to)
+{
+	swapcontext(&((struct simctx *)from)->uc,
+		    &((struct simctx *)to)->uc);
+}
+
+int	sim_vprintf(const char *fmt, __builtin_va_list ap)
+{
+	return vprintf(fmt, ap);
+}
+
+void	*xmemset(void *s, const int c, int n)
+{
+	return memset(s, c, (size_t)n);
+}
+
+void	*xmemcpy(void *d, const void *s, int n)
+{
+	return memcpy(d, s, (size_t)n);
+}
+
+/* Print a schedule as a comma-separated list */
+
+static	void	prsched(const unsigned int *sched, int nsched)
+{
+	int	i;
+
+	for (i = 0; i < nsched; i++) {
+		printf("%s%u", (i == 0) ? "" : ",", sched[i]);
+	}
+	if (nsched == 0) {
+		printf("none");
+	}
+}
+
+/* Run one test with one seed and schedule, in a child unless inproc is	*/
+/*   set; return 0 if it passed and store the preemption points reached	*/
+
+static	int	runone(int t, unsigned int seed, const unsigned int *sched,
+			int nsched, int verbose, int inproc,
+			unsigned int *npoint)
+{
+	pid_t	pid;
+	int	wstat;
+
+	if (inproc) {
+		return sim_runtest(t, seed, sched, nsched, verbose, npoint);
+	}
+	fflush(stdout);
+	*childpts = 0;
+	if ((pid = fork()) < 0) {
+		perror("xsim: fork");
+		exit(2);
+	}
+	if (pid == 0) {
+		alarm(SIMWALL);		/* A corrupted queue can loop	*/
+		wstat = sim_runtest(t, seed, sched, nsched, verbose,
+				childpts);
+		fflush(stdout);
+		_exit(wstat);
+	}
+	if (waitpid(pid, &wstat, 0) < 0) {
+		perror("xsim: waitpid");
+		exit(2);
+	}
+	*npoint = *childpts;
+	if (WIFSIGNALED(wstat)) {
+		if (verbose >= 0) {
+			printf("sim=%s seed=%u result=FAIL signal=%d",
+				sim_testname(t), seed, WTERMSIG(wstat));
+			if (nsched > 0) {
+				printf(" preempt=");
+				prsched(sched, nsched);
+			}
+			printf("\n");
+		}
+		return 1;
+	}
+	return WEXITSTATUS(wstat) != 0;
+}
+
+/* Run one schedule of an exploration silently, remembering the first	*/
+/*   that fails								*/
+
+static	int	exrun(int t, unsigned int seed, const unsigned int *sched,
+			int nsched, unsigned int *npoint)
+{
+	exruns++;
+	if (runone(t, seed, sched, nsched, -1, 0, npoint) == 0) {
+		return 0;
+	}
+	if (exfailed++ == 0) {
+		memcpy(exbad, sched, nsched * sizeof(sched[0]));
+		nexbad = nsched;
+	}
+	return 1;
+}
+
+/* Systematic exploration: with sched[0..k) fixed and npoint points in	*/
+/*   the run it gives, try every later point as preemption k, and	*/
+/*   recurse until schedules have depth entries.  The caller deepens	*/
+/*   one level at a time, so a budget that runs out has covered every	*/
+/*   shallower schedule first.						*/
+
+static	void	exall(int t, unsigned int seed, unsigned int *sched, int k,
+			int depth, unsigned int from, unsigned int npoint,
+			int budget)
+{
+	unsigned int	p, np;
+
+	for (p = from; (p < npoint) && (exruns < budget); p++) {
+		sched[k] = p;
+		if (k + 1 == depth) {
+			exrun(t, seed, sched, k + 1, &np);
+		} else {
+			exruns++;	/* Prefix, judged one level up	*/
+			runone(t, seed, sched, k + 1, -1, 0, &np);
+			exall(t, seed, sched, k + 1, depth, p + 1, np,
+				budget);
+		}
+	}
+}
+
+/* Random exploration: schedules of 1 to depth preemptions drawn	*/
+/*   uniformly from the points of the unpreempted run			*/
+
+static	void	exrandom(int t, unsigned int seed, int depth,
+			unsigned int npoint, int budget)
+{
+	unsigned int	sched[SIMMAXPRE];
+	unsigned int	rng = seed, p, np;
+	int	n, i, j;
+
+	while ((exruns < budget) && (npoint > 0)) {
+		rng = rng * 1103515245 + 12345;
+		n = 1 + (rng >> 16) % depth;
+		for (i = 0; i < n; i++) {
+			rng = rng * 1103515245 + 12345;
+			p = ((rng >> 8) ^ (rng << 7)) % npoint;
+			for (j = i; (j > 0) && (sched[j - 1] > p); j--) {
+				sched[j] = sched[j - 1];
+			}
+			sched[j] = p;
+		}
+		for (i = 1, j = 1; i < n; i++) {	/* Drop repeats	*/
+			if (sched[i] != sched[j - 1]) {
+				sched[j++] = sched[i];
+			}
+		}
+		exrun(t, seed, sched, j, &np);
+	}
+}
+
+/* Minimize a failing schedule: drop preemptions one at a time while	*/
+/*   the run still fails, until no single one can go			*/
+
+static	int	minimize(int t, unsigned int seed, unsigned int *sched,
+			int nsched)
+{
+	unsigned int	trial[SIMMAXPRE], np;
+	int	i, changed;
+
+	do {
+		changed = 0;
+		for (i = 0; i < nsched; ) {
+			memcpy(trial, sched, i * sizeof(sched[0]));
+			memcpy(trial + i, sched + i + 1,
+				(nsched - i - 1) * sizeof(sched[0]));
+			if (runone(t, seed, trial, nsched - 1, -1, 0, &np)) {
+				memcpy(sched, trial,
+					(nsched - 1) * sizeof(sched[0]));
+				nsched--;
+				changed = 1;
+			} else {
+				i++;
+			}
+		}
+	} while (changed);
+	return nsched;
+}
+
+/* Explore schedules of test t, report, and return 1 if any failed */
+
+static	int	explore(int t, unsigned int seed, int systematic, int depth,
+			int budget)
+{
+	unsigned int	sched[SIMMAXPRE], npoint;
+	int	d;
+
+	exruns = exfailed = nexbad = 0;
+	if (runone(t, seed, NULL, 0, 0, 0, &npoint)) {
+		printf("sim=%s explore=%s seed=%u: fails without "
+			"preemption\n", sim_testname(t),
+			systematic ? "all" : "random", seed);
+		return 1;
+	}
+	if (systematic) {
+		for (d = 1; (d <= depth) && (exruns < budget); d++) {
+			exall(t, seed, sched, 0, d, 0, npoint, budget);
+		}
+	} else {
+		exrandom(t, seed, depth, npoint, budget);
+	}
+	printf("sim=%s explore=%s seed=%u depth=%d points=%u runs=%d "
+		"failed=%d\n", sim_testname(t), systematic ? "all" : "random",
+		seed, depth, npoint, exruns, exfailed);
+	if (exfailed == 0) {
+		return 0;
+	}
+	printf("sim=%s failing preempt=", sim_testname(t));
+	prsched(exbad, nexbad);
+	printf("\n");
+	nexbad = minimize(t, seed, exbad, nexbad);
+	runone(t, seed, exbad, nexbad, 0, 0, &npoint);
+	printf("sim=%s minimized seed=%u preempt=", sim_testname(t), seed);
+	prsched(exbad, nexbad);
+	printf("  (replay: xsim -v -s %u -p ", seed);
+	prsched(exbad, nexbad);
+	printf(" %s)\n", sim_testname(t));
+	return 1;
+}
+
+/* Parse a schedule: ascending point numbers separated by commas */
+
+static	int	parsesched(char *arg, unsigned int *sched)
+{
+	char	*end;
+	int	n = 0;
+
+	while (*arg != '\0') {
+		if (n == SIMMAXPRE) {
+			return -1;
+		}
+		sched[n] = strtoul(arg, &end, 0);
+		if ((end == arg) || ((n > 0) && (sched[n] <= sched[n - 1]))) {
+			return -1;
+		}
+		n++;
+		arg = (*end == ',') ? end + 1 : end;
+	}
+	return n;
+}
+
+static	void	usage(void)
+{
+	int	t;
+
+	fprintf(stderr, "usage: xsim [-v] [-x] [-m] [-s seed] [-n runs] "
+			"[-p points] [-e all|random [-d depth]] [test ...]\n"
+			"  -v  report every run and show klog output\n"
+			"  -x  run in this process (one run only)\n"
+			"  -s  first seed (default 1)\n"
+			"  -n  seeds to run per test (default 1), or runs per "
+			"exploration (default %d)\n"
+			"  -p  preempt at these points, e.g. 12,40,77\n"
+			"  -m  minimize the -p schedule if the run fails\n"
+			"  -e  explore schedules, every one (all) or at "
+			"random\n"
+			"  -d  most preemptions per explored schedule "
+			"(default 2)\n"
+			"tests:", SIMBUDGET);
+	for (t = 0; sim_testname(t) != NULL; t++) {
+		fprintf(stderr, " %s", sim_testname(t));
+	}
+	fprintf(stderr, "\n");
+	exit(2);
+}
+
+int	main(int argc, char *argv[])
+{
+	unsigned int	seed = 1;	/* First seed			*/
+	unsigned int	s, npoint;
+	unsigned int	sched[SIMMAXPRE];	/* Schedule from -p	*/
+	int	nsched = 0;
+	int	nruns = 0;		/* Seeds per test, or budget	*/
+	int	verbose = 0, inproc = 0, mini = 0;
+	int	exmode = -1;		/* 1 all, 0 random, -1 neither	*/
+	int	depth = 2;
+	int	ntest, t, i, c, failed, firstbad, total = 0;
+	int	*pick;			/* Tests named on command line	*/
+
+	while ((c = getopt(argc, argv, "vxms:n:p:e:d:")) != -1) {
+		switch (c) {
+		case 'v':	verbose = 1;			break;
+		case 'x':	inproc = 1;			break;
+		case 'm':	mini = 1;			break;
+		case 's':	seed = strtoul(optarg, NULL, 0);	break;
+		case 'n':	nruns = atoi(optarg);		break;
+		case 'd':	depth = atoi(optarg);		break;
+		case 'p':
+			if ((nsched = parsesched(optarg, sched)) < 0) {
+				usage();
+			}
+			break;
+		case 'e':
+			if (strcmp(optarg, "all") == 0) {
+				exmode = 1;
+			} else if (strcmp(optarg, "random") == 0) {
+				exmode = 0;
+			} else {
+				usage();
+			}
+			break;
+		default:	usage();
+		}
+	}
+	for (ntest = 0; sim_testname(ntest) != NULL; ntest++)
+		;
+	if ((pick = calloc(ntest, sizeof(int))) == NULL) {
+		return 2;
+	}
+	if (optind == argc) {
+		for (t = 0; t < ntest; t++) {
+			pick[t] = 1;
+		}
+	}
+	for (i = optind; i < argc; i++) {
+		for (t = 0; t < ntest; t++) {
+			if (strcmp(argv[i], sim_testname(t)) == 0) {
+				pick[t] = 1;
+				break;
+			}
+		}
+		if (t == ntest) {
+			fprintf(stderr, "xsim: no test named %s\n", argv[i]);
+			usage();
+		}
+	}
+	if (nruns == 0) {
+		nruns = (exmode >= 0) ? SIMBUDGET : 1;
+	}
+	if ((inproc && ((nruns != 1) || (exmode >= 0) || mini))
+	    || (depth < 1) || (depth > SIMMAXPRE)
+	    || ((exmode >= 0) && (nsched > 0))) {
+		usage();
+	}
+	childpts = mmap(NULL, sizeof(*childpts), PROT_READ | PROT_WRITE,
+			MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+	if (childpts == MAP_FAILED) {
+		perror("xsim: mmap");
+		return 2;
+	}
+
+	for (t = 0; t < ntest; t++) {
+		if (!pick[t]) {
+			continue;
+		}
+		if (exmode >= 0) {
+			total += explore(t, seed, exmode, depth, nruns);
+			continue;
+		}
+		failed = 0;
+		firstbad = -1;
+		for (s = seed; s < seed + (unsigned int)nruns; s++) {
+			if (runone(t, s, sched, nsched, verbose, inproc,
+				   &npoint)) {
+				if (failed++ == 0) {
+					firstbad = (int)s;
+				}
+			}
+		}
+		printf("sim=%s runs=%d failed=%d", sim_testname(t), nruns,
+			failed);
+		if (failed) {
+			printf(" first_failed_seed=%d", firstbad);
+		}
+		printf("\n");
+		if (failed && mini && (nsched > 0)) {
+			memcpy(exbad, sched, nsched * sizeof(sched[0]));
+			nexbad = minimize(t, (unsigned int)firstbad, exbad,
+					nsched);
+			printf("sim=%s minimized seed=%d preempt=",
+				sim_testname(t), firstbad);
+			prsched(exbad, nexbad);
+			printf("\n");
+		}
+		total += failed;
+	}
+	return total != 0;
+}
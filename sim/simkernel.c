@@ -0,0 +1,622 @@
+/* simkernel.c - simstep, simrand, simwork, simrun, disable, restore,	*/
+/*		 test_and_set, getticks, ctxsw, newqueue, enqueue,	*/
+/*		 dequeue, create, resume, kill, getpid, getprio,	*/
+/*		 yield, userret, klog, sim_runtest			*/
+
+/* The parts of the kernel that the simulation replaces: the process	*/
+/*   table and queue storage, the interrupt flag, the clock chip, the	*/
+/*   context switch, and process creation.  Everything else that a run	*/
+/*   exercises (locks, resched, the ready list, sleep, the timing	*/
+/*   wheel, and the clock handler) is compiled from ../system as is.	*/
+
+#include <xinu.h>
+
+struct	procent	proctab[NPROC];	/* Process table			*/
+struct	qentry	queuetab[NQENT];/* Queue table				*/
+struct	sentry	semtab[NSEM];	/* Semaphore table			*/
+pid32	currpid;		/* Currently executing process		*/
+int32	prcount;		/* Currently active processes		*/
+uint32	preempt;		/* Ticks left in the time slice		*/
+uint32	clktime;		/* Seconds since the run began		*/
+uint32	ctr1000;		/* Milliseconds since the run began	*/
+
+struct	simstate sim;		/* Virtual machine state		*/
+
+struct	simproc	{		/* Host-side state of one process	*/
+	void	*spfunc;	/* Function the process runs		*/
+	int32	sparg[4];	/* Its arguments			*/
+};
+
+local	struct	simproc	simproc[NPROC];
+local	void	*simmain;	/* First process of the current run	*/
+local	qid16	nextqid;	/* Next queue head newqueue hands out	*/
+local	pid32	nextpid;	/* Where create starts its search	*/
+
+/*------------------------------------------------------------------------
+ *  simrand  -  Return the next value of the run's seeded generator
+ *------------------------------------------------------------------------
+ */
+uint32	simrand(void)
+{
+	sim.seed = sim.seed * 1103515245 + 12345;
+	return sim.seed >> 16;
+}
+
+/*------------------------------------------------------------------------
+ *  simtick  -  Deliver the clock interrupts that have come due
+ *------------------------------------------------------------------------
+ */
+local	void	simtick(void)
+{
+	while (sim.clock >= sim.nexttick) {
+		sim.nexttick += SIMCYCMS;
+		sim.intr = FALSE;	/* The handler runs masked	*/
+		clkhandler();		/* May switch to another proc.	*/
+		sim.intr = TRUE;
+	}
+}
+
+/*------------------------------------------------------------------------
+ *  simpreempt  -  End the current time slice, as the clock handler
+ *		     does when preempt reaches zero
+ *------------------------------------------------------------------------
+ */
+local	void	simpreempt(void)
+{
+	sim.intr = FALSE;
+	preempt = QUANTUM;
+	resched();
+	sim.intr = TRUE;
+}
+
+/*------------------------------------------------------------------------
+ *  simstep  -  Advance virtual time by cost plus jitter; a tick that
+ *		  comes due is taken now if interrupts are enabled and
+ *		  otherwise when they next are.  With interrupts enabled
+ *		  the step is a preemption point, taken if the schedule
+ *		  names it.
+ *------------------------------------------------------------------------
+ */
+void	simstep(
+	  uint32	cost		/* Cycles the step takes	*/
+	)
+{
+	uint32	point;			/* This step's preemption point	*/
+
+	sim.clock += cost + simrand() % SIMJITTER;
+	sim.steps++;
+	if ((sim.clock >= SIMLIMIT) && (sim.result == SIM_DONE)) {
+		sim.result = SIM_TIMEOUT;
+		sim_ctxswap(proctab[currpid].prstkptr, sim_ctxhost());
+	}
+	if (sim.intr && (sim.clock >= sim.nexttick)) {
+		simtick();
+	}
+	if (sim.intr) {
+		point = sim.npoint++;
+		if ((sim.nextsched < sim.nsched)
+		    && (sim.sched[sim.nextsched] == point)) {
+			sim.nextsched++;
+			simpreempt();
+		}
+	}
+}
+
+/*------------------------------------------------------------------------
+ *  simwork  -  Stand in for cycles of computation by a test process
+ *------------------------------------------------------------------------
+ */
+void	simwork(
+	  uint32	cycles		/* Cycles of work		*/
+	)
+{
+	uint32	c;
+
+	while (cycles > 0) {
+		c = (cycles < 10 * SIMCOST) ? cycles : 10 * SIMCOST;
+		simstep(c);
+		cycles -= c;
+	}
+}
+
+/*------------------------------------------------------------------------
+ *  disable, restore  -  Clear and restore the simulated interrupt flag
+ *------------------------------------------------------------------------
+ */
+intmask	disable(void)
+{
+	intmask	mask;
+
+	simstep(SIMCOST);
+	mask = sim.intr;
+	sim.intr = FALSE;
+	return mask;
+}
+
+void	restore(
+	  intmask	mask		/* Value returned by disable	*/
+	)
+{
+	sim.intr = mask;
+	simstep(SIMCOST);
+}
+
+/*------------------------------------------------------------------------
+ *  test_and_set  -  Atomically store a new value and return the old one
+ *------------------------------------------------------------------------
+ */
+uint32	test_and_set(
+	  uint32	*ptr,		/* Word to set			*/
+	  uint32	new_value	/* Value to store		*/
+	)
+{
+	uint32	old;
+
+	simstep(SIMCOST);		/* May be preempted before,	*/
+	old = *ptr;			/*   never in the middle	*/
+	*ptr = new_value;
+	return old;
+}
+
+/*------------------------------------------------------------------------
+ *  getticks  -  Return the virtual cycle counter
+ *------------------------------------------------------------------------
+ */
+uint64	getticks(void)
+{
+	return sim.clock;
+}
+
+/*------------------------------------------------------------------------
+ *  ctxsw  -  Switch host contexts; the interrupt flag is saved and
+ *	      restored around the switch as the flags register is on
+ *	      the target
+ *------------------------------------------------------------------------
+ */
+void	ctxsw(
+	  void		*old,		/* Old process's prstkptr	*/
+	  void		*new		/* New process's prstkptr	*/
+	)
+{
+	bool8	intr = sim.intr;
+
+	sim.nswitch++;
+	sim_ctxswap(*(void **)old, *(void **)new);
+	sim.intr = intr;
+}
+
+/*------------------------------------------------------------------------
+ *  newqueue  -  Allocate and initialize a queue in the global queue table
+ *------------------------------------------------------------------------
+ */
+qid16	newqueue(void)
+{
+	qid16	q;
+
+	q = nextqid;
+	if (q >= NQENT) {
+		return SYSERR;
+	}
+	nextqid += 2;
+
+	queuetab[queuehead(q)].qnext = queuetail(q);
+	queuetab[queuehead(q)].qprev = EMPTY;
+	queuetab[queuehead(q)].qkey  = MAXKEY;
+	queuetab[queuetail(q)].qnext = EMPTY;
+	queuetab[queuetail(q)].qprev = queuehead(q);
+	queuetab[queuetail(q)].qkey  = MINKEY;
+	return q;
+}
+
+/*------------------------------------------------------------------------
+ *  enqueue  -  Insert a process at the tail of a queue
+ *------------------------------------------------------------------------
+ */
+pid32	enqueue(
+	  pid32		pid,		/* ID of process to insert	*/
+	  qid16		q		/* ID of queue to use		*/
+	)
+{
+	qid16	tail, prev;
+
+	simstep(SIMCOST);
+	if (isbadqid(q) || isbadpid(pid)) {
+		return SYSERR;
+	}
+	tail = queuetail(q);
+	prev = queuetab[tail].qprev;
+
+	queuetab[pid].qnext  = tail;
+	queuetab[pid].qprev  = prev;
+	queuetab[prev].qnext = pid;
+	queuetab[tail].qprev = pid;
+	return pid;
+}
+
+/*------------------------------------------------------------------------
+ *  dequeue  -  Remove and return the first process on a list
+ *------------------------------------------------------------------------
+ */
+pid32	dequeue(
+	  qid16		q		/* ID of queue to use		*/
+	)
+{
+	pid32	pid;
+
+	simstep(SIMCOST);
+	if (isbadqid(q)) {
+		return SYSERR;
+	} else if (isempty(q)) {
+		return EMPTY;
+	}
+	pid = getfirst(q);
+	queuetab[pid].qprev = EMPTY;
+	queuetab[pid].qnext = EMPTY;
+	return pid;
+}
+
+/*------------------------------------------------------------------------
+ *  simentry  -  First code run by a new process: call its function
+ *		   with interrupts enabled and exit when it returns
+ *------------------------------------------------------------------------
+ */
+local	void	simentry(void)
+{
+	struct	simproc	*sp = &simproc[currpid];
+
+	sim.intr = TRUE;
+	((process (*)(int32, int32, int32, int32))sp->spfunc)(sp->sparg[0],
+			sp->sparg[1], sp->sparg[2], sp->sparg[3]);
+	userret();
+}
+
+/*------------------------------------------------------------------------
+ *  create  -  Create a suspended process on a host context; at most
+ *	       four int32 arguments, and ssize is not used
+ *------------------------------------------------------------------------
+ */
+pid32	create(
+	  void		*funcaddr,	/* Address of the function	*/
+	  uint32	ssize,		/* Stack size in bytes		*/
+	  pri16		priority,	/* Process priority > 0		*/
+	  char		*name,		/* Name (for debugging)		*/
+	  uint32	nargs,		/* Number of args that follow	*/
+	  ...
+	)
+{
+	__builtin_va_list ap;
+	intmask	mask;			/* Saved interrupt mask		*/
+	struct	procent	*prptr;		/* Pointer to proc. table entry */
+	pid32	pid;
+	int32	i;
+
+	mask = disable();
+	for (i = 0; i < NPROC; i++) {
+		pid = nextpid;
+		nextpid = (nextpid + 1) % NPROC;
+		if ((pid != NULLPROC) && (proctab[pid].prstate == PR_FREE)) {
+			break;
+		}
+	}
+	if ((priority < 1) || (nargs > 4) || (i == NPROC)) {
+		restore(mask);
+		return SYSERR;
+	}
+	prptr = &proctab[pid];
+	if (prptr->prstkptr != NULL) {	/* Left by an exited process	*/
+		sim_ctxfree(prptr->prstkptr);
+	}
+	xmemset(prptr, 0, sizeof(struct procent));
+	if ((prptr->prstkptr = sim_ctxnew(simentry)) == NULL) {
+		restore(mask);
+		return SYSERR;
+	}
+
+	prcount++;
+	prptr->prstate = PR_SUSP;
+	prptr->prprio = priority;
+	for (i = 0; i < PNMLEN - 1 && (prptr->prname[i] = name[i]) != NULLCH;
+	     i++)
+		;
+	prptr->prsem = -1;
+	prptr->prmutex = -1;
+	prptr->prparent = currpid;
+	prptr->pendingLockId = -1;
+	prptr->starttime = getticks();
+	prptr->prentry = funcaddr;
+
+	simproc[pid].spfunc = funcaddr;
+	__builtin_va_start(ap, nargs);
+	for (i = 0; i < 4; i++) {
+		simproc[pid].sparg[i] = (i < nargs) ?
+				__builtin_va_arg(ap, int32) : 0;
+	}
+	__builtin_va_end(ap);
+	restore(mask);
+	return pid;
+}
+
+/*------------------------------------------------------------------------
+ *  resume  -  Unsuspend a process, making it ready
+ *------------------------------------------------------------------------
+ */
+pri16	resume(
+	  pid32		pid		/* ID of process to unsuspend	*/
+	)
+{
+	intmask	mask;
+	pri16	prio;
+
+	mask = disable();
+	if (isbadpid(pid) || (proctab[pid].prstate != PR_SUSP)) {
+		restore(mask);
+		return (pri16)SYSERR;
+	}
+	prio = proctab[pid].prprio;
+	ready(pid);
+	restore(mask);
+	return prio;
+}
+
+/*------------------------------------------------------------------------
+ *  kill  -  Terminate a process; one waiting on a lock, semaphore, or
+ *	     mailbox is taken off its queue, and its joiners and
+ *	     blocked senders are started
+ *------------------------------------------------------------------------
+ */
+syscall	kill(
+	  pid32		pid		/* ID of process to kill	*/
+	)
+{
+	intmask	mask;
+	struct	procent	*prptr;
+
+	mask = disable();
+	if (isbadpid(pid) || (pid == NULLPROC)) {
+		restore(mask);
+		return SYSERR;
+	}
+	prptr = &proctab[pid];
+	prcount--;
+	mbrelease(pid);
+	joinrelease(pid);
+	semrelease(pid);
+	dwrelease(pid);
+
+	switch (prptr->prstate) {
+	case PR_CURR:
+		prptr->prstate = PR_FREE;
+		resched();		/* Does not return		*/
+
+	case PR_SLEEP:
+	case PR_RECTIM:
+		unsleep(pid);
+		prptr->prstate = PR_FREE;
+		break;
+
+	case PR_WAIT:
+		if (!prptr->l_flag) {
+			semtab[prptr->prsem].scount++;
+		}
+		/* Fall through */
+
+	case PR_SEND:
+	case PR_JOIN:
+	case PR_READY:
+		getitem(pid);
+		/* Fall through */
+
+	default:
+		prptr->prstate = PR_FREE;
+	}
+	restore(mask);
+	return OK;
+}
+
+/*------------------------------------------------------------------------
+ *  getpid, getprio, yield, userret  -  As on the target
+ *------------------------------------------------------------------------
+ */
+pid32	getpid(void)
+{
+	return currpid;
+}
+
+syscall	getprio(
+	  pid32		pid		/* Process ID			*/
+	)
+{
+	if (isbadpid(pid)) {
+		return SYSERR;
+	}
+	return proctab[pid].prprio;
+}
+
+syscall	yield(void)
+{
+	intmask	mask;
+
+	mask = disable();
+	resched();
+	restore(mask);
+	return OK;
+}
+
+void	userret(void)
+{
+	kill(getpid());
+}
+
+/*------------------------------------------------------------------------
+ *  klog, kprintf  -  Print through the host; klog output is shown only
+ *		      in verbose runs, but deadlock reports are counted
+ *------------------------------------------------------------------------
+ */
+syscall	klog(
+	  char		*fmt,		/* Format			*/
+	  ...
+	)
+{
+	__builtin_va_list ap;
+	char	*p, *q;
+
+	simstep(SIMCOST);
+	for (p = fmt, q = "deadlock_detected"; *q != NULLCH && *p == *q;
+	     p++, q++)
+		;
+	if (*q == NULLCH) {
+		sim.ndeadlock++;
+	}
+	if (sim.verbose) {
+		__builtin_va_start(ap, fmt);
+		sim_vprintf(fmt, ap);
+		__builtin_va_end(ap);
+	}
+	return OK;
+}
+
+int	kprintf(
+	  const char	*fmt,		/* Format			*/
+	  ...
+	)
+{
+	__builtin_va_list ap;
+	int	n;
+
+	__builtin_va_start(ap, fmt);
+	n = sim_vprintf(fmt, ap);
+	__builtin_va_end(ap);
+	return n;
+}
+
+/*------------------------------------------------------------------------
+ *  simsleepers  -  Return TRUE if some process will be awakened by a
+ *		      timer
+ *------------------------------------------------------------------------
+ */
+local	bool8	simsleepers(void)
+{
+	pid32	pid;
+
+	for (pid = 0; pid < NPROC; pid++) {
+		if ((proctab[pid].prstate == PR_SLEEP)
+		    || (proctab[pid].prstate == PR_RECTIM)) {
+			return TRUE;
+		}
+	}
+	return FALSE;
+}
+
+/*------------------------------------------------------------------------
+ *  simnull  -  The null process: start the run's first process, then
+ *		  idle from tick to tick until no other process is left
+ *		  or none can ever run again
+ *------------------------------------------------------------------------
+ */
+local	void	simnull(void)
+{
+	sim.intr = TRUE;
+	resume(create(simmain, SIMSTK, INITPRIO, "main", 0));
+
+	while (prcount > 1) {
+		if (!rqisempty()) {
+			yield();
+			continue;
+		}
+		if (!simsleepers()) {
+			sim.result = SIM_STUCK;
+			break;
+		}
+		sim.clock = sim.nexttick;	/* Idle until the next tick	*/
+		simstep(0);
+	}
+	sim_ctxswap(proctab[NULLPROC].prstkptr, sim_ctxhost());
+}
+
+/*------------------------------------------------------------------------
+ *  simrun  -  Run the system from a clean state with mainfn as its
+ *		 first process and return how the run ended; the lock
+ *		 modules keep counters of their own, so each run needs a
+ *		 fresh host process
+ *------------------------------------------------------------------------
+ */
+int32	simrun(
+	  void		*mainfn,	/* First process		*/
+	  uint32	seed,		/* Seed for the jitter		*/
+	  const uint32	*sched,		/* Points to preempt at		*/
+	  int32		nsched,		/* Entries in sched		*/
+	  int32		verbose		/* Print klog output		*/
+	)
+{
+	struct	procent	*prptr;
+
+	xmemset(&sim, 0, sizeof(sim));
+	sim.seed = seed;
+	sim.sched = sched;
+	sim.nsched = nsched;
+	sim.verbose = verbose;
+	sim.nexttick = SIMCYCMS;
+
+	xmemset(proctab, 0, sizeof(proctab));
+	xmemset(queuetab, 0, sizeof(queuetab));
+	xmemset(semtab, 0, sizeof(semtab));
+	xmemset(mbsendq, 0, NPROC * sizeof(qid16));
+	xmemset(&readyq, 0, sizeof(readyq));
+	twinit();
+	Defer.ndefers = 0;
+	nextqid = NPROC;
+	nextpid = 1;
+	preempt = QUANTUM;
+	ctr1000 = clktime = 0;
+
+	prptr = &proctab[NULLPROC];
+	prptr->prstate = PR_CURR;
+	prptr->prprio = 0;
+	prptr->pendingLockId = -1;
+	prptr->prmutex = -1;
+	xmemcpy(prptr->prname, "prnull", 7);
+	prptr->prstkptr = sim_ctxnew(simnull);
+	currpid = NULLPROC;
+	prcount = 1;
+
+	simmain = mainfn;
+	sim_ctxswap(sim_ctxhost(), prptr->prstkptr);
+	return sim.result;
+}
+
+/*------------------------------------------------------------------------
+ *  sim_runtest  -  Run test i with a seed and a schedule and judge the
+ *		      result; verbose is 1 to report every run, 0 to
+ *		      report failures, and -1 for silence
+ *------------------------------------------------------------------------
+ */
+int	sim_runtest(
+	  int		i,		/* Index into simtesttab	*/
+	  unsigned int	seed,		/* Seed for the run		*/
+	  const unsigned int *sched,	/* Points to preempt at		*/
+	  int		nsched,		/* Entries in sched		*/
+	  int		verbose,	/* Reporting level		*/
+	  unsigned int	*npoint		/* Preemption points reached	*/
+	)
+{
+	static	char	*endname[] = { "done", "stuck", "timeout" };
+	struct	simtest	*st = &simtesttab[i];
+	bool8	ok;
+	int32	j;
+
+	simrun(st->stmain, seed, sched, nsched, verbose > 0);
+	ok = st->stcheck();
+	*npoint = sim.npoint;
+	if ((verbose > 0) || (!ok && (verbose == 0))) {
+		kprintf("sim=%s seed=%u result=%s end=%s vcycles=%u steps=%u "
+			"ctxsw=%u points=%u", st->stname, seed,
+			ok ? "ok" : "FAIL", endname[sim.result],
+			(uint32)sim.clock, (uint32)sim.steps, sim.nswitch,
+			sim.npoint);
+		for (j = 0; j < nsched; j++) {
+			kprintf("%s%u", (j == 0) ? " preempt=" : ",", sched[j]);
+		}
+		kprintf("\n");
+	}
+	return ok ? 0 : 1;
+}
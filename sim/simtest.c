@@ -0,0 +1,583 @@
+/* simtest.c - simtesttab and the tests it lists */
+
+#include <xinu.h>
+
+#define	STNWORK		4		/* Workers in a mutual excl. run*/
+#define	STITERS		50		/* Acquisitions per worker	*/
+#define	STHOLD		3000		/* Longest critical section	*/
+#define	STTHINK		6000		/* Longest time between them	*/
+#define	STPRIO		10		/* Base worker priority		*/
+
+#define	ST_SL		0		/* Lock family under test	*/
+#define	ST_LOCK		1
+#define	ST_AL		2
+#define	ST_PI		3
+#define	ST_SLIRQ	4		/* sl_lock_irqsave on stsl	*/
+
+local	sl_lock_t	stsl;		/* One lock of each family	*/
+local	lock_t		stlk;
+local	al_lock_t	stal, stal2;
+local	pi_lock_t	stpi;
+local	intmask		stmask;		/* Saved by sl_lock_irqsave	*/
+
+local	uint32	stcount;		/* Protected counter		*/
+local	pid32	stowner;		/* Process inside, 0 if none	*/
+local	uint32	stviol;			/* Mutual exclusion violations	*/
+local	uint32	stexpect;		/* Final value stcount needs	*/
+local	uint32	stcut;			/* sl_lock holds cut by a switch*/
+
+/*------------------------------------------------------------------------
+ *  st_acquire, st_release  -  Operate on the lock of one family
+ *------------------------------------------------------------------------
+ */
+local	void	st_acquire(
+	  int32		kind		/* Lock family (ST_*)		*/
+	)
+{
+	switch (kind) {
+	case ST_SL:	sl_lock(&stsl);		break;
+	case ST_LOCK:	lock(&stlk);		break;
+	case ST_AL:	al_lock(&stal);		break;
+	case ST_PI:	pi_lock(&stpi);		break;
+	case ST_SLIRQ:	stmask = sl_lock_irqsave(&stsl);	break;
+	}
+}
+
+local	void	st_release(
+	  int32		kind		/* Lock family (ST_*)		*/
+	)
+{
+	switch (kind) {
+	case ST_SL:	sl_unlock(&stsl);	break;
+	case ST_LOCK:	unlock(&stlk);		break;
+	case ST_AL:	al_unlock(&stal);	break;
+	case ST_PI:	pi_unlock(&stpi);	break;
+	case ST_SLIRQ:	sl_unlock_irqrestore(&stsl, stmask);	break;
+	}
+}
+
+/*------------------------------------------------------------------------
+ *  st_worker  -  Enter the critical section iters times, checking that
+ *		    nobody else is inside, that no increment is lost, and
+ *		    that an sl_lock holder is never preempted
+ *------------------------------------------------------------------------
+ */
+local	process	st_worker(
+	  int32		kind,		/* Lock family (ST_*)		*/
+	  int32		iters		/* Acquisitions to make		*/
+	)
+{
+	uint32	v, nsw;
+	int32	i;
+
+	for (i = 0; i < iters; i++) {
+		st_acquire(kind);
+		if (stowner != 0) {
+			stviol++;
+		}
+		stowner = currpid;
+		nsw = proctab[currpid].num_invsw;
+		v = stcount;
+		simwork(simrand() % STHOLD);
+		stcount = v + 1;
+		if (stowner != currpid) {
+			stviol++;
+		}
+		if (((kind == ST_SL) || (kind == ST_SLIRQ))
+		    && (proctab[currpid].num_invsw != nsw)) {
+			stcut++;
+		}
+		stowner = 0;
+		st_release(kind);
+		if (simrand() % 4 == 0) {
+			sleepms(1);	/* Let lower priorities in	*/
+		} else {
+			simwork(simrand() % STTHINK);
+		}
+	}
+	return OK;
+}
+
+/*------------------------------------------------------------------------
+ *  st_mutex  -  Start STNWORK workers on one lock.  Spinning waiters
+ *		   above the holder would never let it run, so sl_lock
+ *		   workers share one priority; the others get a random
+ *		   spread so handoff and inheritance are exercised.
+ *------------------------------------------------------------------------
+ */
+local	void	st_mutex(
+	  int32		kind		/* Lock family (ST_*)		*/
+	)
+{
+	pid32	pids[STNWORK];
+	pri16	prio;
+	int32	i;
+
+	switch (kind) {
+	case ST_SL:
+	case ST_SLIRQ:	sl_initlock(&stsl);	break;
+	case ST_LOCK:	initlock(&stlk);	break;
+	case ST_AL:	al_initlock(&stal);	break;
+	case ST_PI:	pi_initlock(&stpi);	break;
+	}
+	stcount = stviol = stcut = 0;
+	stowner = 0;
+	stexpect = STNWORK * STITERS;
+	for (i = 0; i < STNWORK; i++) {
+		prio = ((kind == ST_SL) || (kind == ST_SLIRQ)) ? STPRIO
+			: STPRIO + simrand() % 3;
+		pids[i] = create(st_worker, SIMSTK, prio, "worker", 2, kind,
+				STITERS);
+	}
+	for (i = 0; i < STNWORK; i++) {
+		resume(pids[i]);
+	}
+}
+
+/*------------------------------------------------------------------------
+ *  st_main_dwork  -  Run the lock_t workers, whose sleeps end through
+ *			deferred work, then kill the deferred-work process,
+ *			the only one left suspended
+ *------------------------------------------------------------------------
+ */
+local	process	st_main_dwork(void)
+{
+	pid32	pid;
+
+	dwstart();
+	st_mutex(ST_LOCK);
+	for (pid = 1; pid < NPROC; pid++) {
+		if ((pid != currpid) && !isbadpid(pid)
+		    && (proctab[pid].prstate != PR_SUSP)) {
+			join(pid);
+		}
+	}
+	for (pid = 1; pid < NPROC; pid++) {
+		if (!isbadpid(pid) && (proctab[pid].prstate == PR_SUSP)) {
+			kill(pid);
+		}
+	}
+	return OK;
+}
+
+local	process	st_main_sl(void)	{ st_mutex(ST_SL);   return OK; }
+local	process	st_main_lock(void)	{ st_mutex(ST_LOCK); return OK; }
+local	process	st_main_al(void)	{ st_mutex(ST_AL);   return OK; }
+local	process	st_main_pi(void)	{ st_mutex(ST_PI);   return OK; }
+local	process	st_main_slirq(void)	{ st_mutex(ST_SLIRQ); return OK; }
+
+/*------------------------------------------------------------------------
+ *  st_check_mutex  -  Every worker finished, nothing overlapped, and no
+ *		       increment was lost
+ *------------------------------------------------------------------------
+ */
+local	bool8	st_check_mutex(void)
+{
+	if (sim.verbose) {
+		kprintf("sim count=%u expect=%u violations=%u cut=%u "
+			"vcycles_per_acquire=%u\n", stcount, stexpect, stviol,
+			stcut, (uint32)(sim.clock / (stcount ? stcount : 1)));
+	}
+	return (sim.result == SIM_DONE) && (stviol == 0) && (stcut == 0)
+		&& (stcount == stexpect);
+}
+
+/* Priority inheritance: L holds the lock in a long critical section,	*/
+/*   H blocks on it, and M would starve L of the CPU unless L inherits	*/
+/*   H's priority						*/
+
+#define	STPIL		5		/* Priorities of L, M, and H	*/
+#define	STPIM		10
+#define	STPIH		15
+#define	STPIWORK	(20 * SIMCYCMS)	/* L's and M's computation	*/
+
+local	pri16	stlheld;		/* L's priority just before	*/
+					/*   releasing			*/
+local	pri16	stlafter;		/* ... and just after		*/
+local	int32	stfinish;		/* Completion order: 1 = H	*/
+local	int32	sthdone, stmdone;	/*   first, and so on		*/
+
+local	process	st_pi_low(void)
+{
+	pi_lock(&stpi);
+	simwork(STPIWORK);
+	stlheld = proctab[currpid].prprio;
+	pi_unlock(&stpi);
+	stlafter = proctab[currpid].prprio;
+	return OK;
+}
+
+local	process	st_pi_mid(void)
+{
+	simwork(STPIWORK);
+	stmdone = ++stfinish;
+	return OK;
+}
+
+local	process	st_pi_high(void)
+{
+	pi_lock(&stpi);
+	pi_unlock(&stpi);
+	sthdone = ++stfinish;
+	return OK;
+}
+
+local	process	st_main_inherit(void)
+{
+	pi_initlock(&stpi);
+	stfinish = sthdone = stmdone = 0;
+	stlheld = stlafter = 0;
+	resume(create(st_pi_low, SIMSTK, STPIL, "low", 0));
+	sleepms(1);			/* Let L take the lock		*/
+	resume(create(st_pi_high, SIMSTK, STPIH, "high", 0));
+	resume(create(st_pi_mid, SIMSTK, STPIM, "mid", 0));
+	return OK;
+}
+
+local	bool8	st_check_inherit(void)
+{
+	if (sim.verbose) {
+		kprintf("sim low_prio_held=%d low_prio_after=%d "
+			"high_done=%d mid_done=%d\n", stlheld, stlafter,
+			sthdone, stmdone);
+	}
+	return (sim.result == SIM_DONE) && (stlheld == STPIH)
+		&& (stlafter == STPIL) && (sthdone < stmdone);
+}
+
+/* Deadlock detection: two processes take two active locks in opposite	*/
+/*   order and sleep in between, so each ends up waiting on the other	*/
+
+local	process	st_dl_proc(
+	  int32		order		/* 0: stal then stal2, 1: reverse*/
+	)
+{
+	al_lock_t *first = order ? &stal2 : &stal;
+	al_lock_t *second = order ? &stal : &stal2;
+
+	al_lock(first);
+	sleepms(2);
+	al_lock(second);		/* Never returns		*/
+	al_unlock(second);
+	al_unlock(first);
+	return OK;
+}
+
+local	process	st_main_deadlock(void)
+{
+	al_initlock(&stal);
+	al_initlock(&stal2);
+	resume(create(st_dl_proc, SIMSTK, STPRIO, "dl_a", 1, 0));
+	resume(create(st_dl_proc, SIMSTK, STPRIO, "dl_b", 1, 1));
+	return OK;
+}
+
+local	bool8	st_check_deadlock(void)
+{
+	return (sim.result == SIM_STUCK) && (sim.ndeadlock == 1);
+}
+
+/* Deadlock detection without delays: the same two processes take the	*/
+/*   locks back to back, so whether they deadlock depends only on	*/
+/*   where they are preempted.  Detection must report exactly the runs	*/
+/*   that end stuck.							*/
+
+local	process	st_abba_proc(
+	  int32		order		/* 0: stal then stal2, 1: reverse*/
+	)
+{
+	al_lock_t *first = order ? &stal2 : &stal;
+	al_lock_t *second = order ? &stal : &stal2;
+
+	al_lock(first);
+	simwork(simrand() % STHOLD);
+	al_lock(second);
+	al_unlock(second);
+	al_unlock(first);
+	return OK;
+}
+
+local	process	st_main_abba(void)
+{
+	al_initlock(&stal);
+	al_initlock(&stal2);
+	resume(create(st_abba_proc, SIMSTK, STPRIO, "abba_a", 1, 0));
+	resume(create(st_abba_proc, SIMSTK, STPRIO, "abba_b", 1, 1));
+	return OK;
+}
+
+local	bool8	st_check_abba(void)
+{
+	if (sim.result == SIM_STUCK) {
+		return sim.ndeadlock == 1;
+	}
+	return (sim.result == SIM_DONE) && (sim.ndeadlock == 0);
+}
+
+/* Mixed deadlocks: cycles through a mutex semaphore and an al lock,	*/
+/*   through join and a full mailbox, and through a mutex semaphore	*/
+/*   and a pi lock.  Each must be reported once, by the process whose	*/
+/*   wait closes it.							*/
+
+local	sid32	stsem, stsem2;		/* Mutex semaphores		*/
+local	pid32	stjoinee;		/* Process the joiner waits for	*/
+
+local	process	st_mx_lockfirst(
+	  int32		kind		/* ST_AL or ST_PI		*/
+	)
+{
+	st_acquire(kind);
+	sleepms(2);
+	wait((kind == ST_AL) ? stsem : stsem2);	/* Never returns	*/
+	return OK;
+}
+
+local	process	st_mx_semfirst(
+	  int32		kind		/* ST_AL or ST_PI		*/
+	)
+{
+	wait((kind == ST_AL) ? stsem : stsem2);
+	sleepms(1);
+	st_acquire(kind);		/* Never returns		*/
+	return OK;
+}
+
+local	process	st_mx_joiner(void)
+{
+	join(stjoinee);			/* Never returns		*/
+	return OK;
+}
+
+local	process	st_mx_sender(
+	  int32		pid		/* Process joining us		*/
+	)
+{
+	int32	i;
+
+	sleepms(1);			/* Let it join first		*/
+	for (i = 0; i <= MBOXLEN; i++) {
+		send(pid, i);		/* The last one blocks		*/
+	}
+	return OK;
+}
+
+local	process	st_main_mixed(void)
+{
+	pid32	joiner;
+
+	al_initlock(&stal);
+	pi_initlock(&stpi);
+	stsem = semmutex();
+	stsem2 = semmutex();
+	resume(create(st_mx_lockfirst, SIMSTK, STPRIO, "mx_al", 1, ST_AL));
+	resume(create(st_mx_semfirst, SIMSTK, STPRIO, "mx_sem", 1, ST_AL));
+	resume(create(st_mx_lockfirst, SIMSTK, STPRIO, "mx_pi", 1, ST_PI));
+	resume(create(st_mx_semfirst, SIMSTK, STPRIO, "mx_sem2", 1, ST_PI));
+	joiner = create(st_mx_joiner, SIMSTK, STPRIO, "mx_join", 0);
+	stjoinee = create(st_mx_sender, SIMSTK, STPRIO, "mx_send", 1, joiner);
+	resume(joiner);
+	resume(stjoinee);
+	return OK;
+}
+
+local	bool8	st_check_mixed(void)
+{
+	return (sim.result == SIM_STUCK) && (sim.ndeadlock == 3);
+}
+
+/* A killed mutex holder: its process ID goes to a new process, which	*/
+/*   then waits on the same mutex.  kill must have forgotten the	*/
+/*   holder, or the wait is taken for a process waiting on itself	*/
+
+local	process	st_sk_holder(void)
+{
+	wait(stsem);
+	receive();			/* Killed while holding stsem	*/
+	return OK;
+}
+
+local	process	st_sk_waiter(void)
+{
+	wait(stsem);			/* Never returns		*/
+	return OK;
+}
+
+local	process	st_main_semkill(void)
+{
+	pid32	victim;
+	pid32	pid;
+
+	stsem = semmutex();
+	victim = create(st_sk_holder, SIMSTK, STPRIO, "sk_hold", 0);
+	resume(victim);
+	sleepms(1);			/* Let it take stsem		*/
+	kill(victim);
+
+	/* Create processes until one is given the victim's ID		*/
+
+	while ((pid = create(st_sk_waiter, SIMSTK, STPRIO, "sk_wait", 0))
+			!= victim) {
+		if (pid == SYSERR) {
+			return SYSERR;
+		}
+		kill(pid);
+	}
+	resume(pid);
+	return OK;
+}
+
+local	bool8	st_check_semkill(void)
+{
+	return (sim.result == SIM_STUCK) && (sim.ndeadlock == 0);
+}
+
+/* A mutex deleted while held must leave its holder's list, or when	*/
+/*   the entry is reused the old holder's death clears the new holder	*/
+
+local	bool8	stsdok;			/* New holder survived the kill	*/
+
+local	process	st_main_semdel(void)
+{
+	pid32	victim;
+	sid32	sem;
+
+	stsdok = FALSE;
+	stsem = semmutex();
+	victim = create(st_sk_holder, SIMSTK, STPRIO, "sd_hold", 0);
+	resume(victim);
+	sleepms(1);			/* Let it take stsem		*/
+	semdelete(stsem);
+
+	/* Create mutexes until one is given the deleted entry		*/
+
+	while ((sem = semmutex()) != stsem) {
+		if (sem == SYSERR) {
+			return SYSERR;
+		}
+		semdelete(sem);
+	}
+	wait(sem);
+	kill(victim);
+	stsdok = (semtab[sem].sholder == getpid());
+	signal(sem);
+	return OK;
+}
+
+local	bool8	st_check_semdel(void)
+{
+	return (sim.result == SIM_DONE) && stsdok;
+}
+
+/* The deferred-work process is killed while idle and its ID goes to	*/
+/*   a new, suspended process.  Clock ticks that queue wakeups must	*/
+/*   not ready that process in its place				*/
+
+local	bool8	stdwran;		/* The new process was started	*/
+
+local	process	st_dw_usurper(void)
+{
+	stdwran = TRUE;
+	return OK;
+}
+
+local	process	st_main_dwkill(void)
+{
+	pid32	dwpid;
+	pid32	pid;
+
+	stdwran = FALSE;
+	dwstart();
+	for (dwpid = 1; dwpid < NPROC; dwpid++) {
+		if (!isbadpid(dwpid) && (proctab[dwpid].prstate == PR_SUSP)) {
+			break;		/* dworkd, idle			*/
+		}
+	}
+	kill(dwpid);
+
+	/* Create processes until one is given dworkd's ID		*/
+
+	while ((pid = create(st_dw_usurper, SIMSTK, STPRIO, "dw_usurp", 0))
+			!= dwpid) {
+		if (pid == SYSERR) {
+			return SYSERR;
+		}
+		kill(pid);
+	}
+	sleepms(5);			/* Ticks whose wakeups would be	*/
+	kill(pid);			/*   deferred			*/
+	return OK;
+}
+
+local	bool8	st_check_dwkill(void)
+{
+	return (sim.result == SIM_DONE) && !stdwran;
+}
+
+/* A sender blocked on a full mailbox is readied when the owner	*/
+/*   receives, but the owner kills itself before the sender runs.	*/
+/*   The send must fail rather than deliver to a dead process		*/
+
+local	pid32	stskrecv;		/* Owner of the full mailbox	*/
+local	syscall	stskrc;			/* What the blocked send gave	*/
+
+local	process	st_sk_recv(void)
+{
+	receive();			/* Readies the sender		*/
+	kill(getpid());			/*   and dies before it runs	*/
+	return OK;
+}
+
+local	process	st_sk_send(void)
+{
+	stskrc = send(stskrecv, 0);	/* Blocks on the full mailbox	*/
+	return OK;
+}
+
+local	process	st_main_sendkill(void)
+{
+	int32	i;
+
+	stskrc = OK;
+	stskrecv = create(st_sk_recv, SIMSTK, STPRIO + 1, "sk_recv", 0);
+	for (i = 0; i < MBOXLEN; i++) {
+		send(stskrecv, i);
+	}
+	resume(create(st_sk_send, SIMSTK, STPRIO, "sk_send", 0));
+	sleepms(1);			/* Let the sender block		*/
+	resume(stskrecv);
+	return OK;
+}
+
+local	bool8	st_check_sendkill(void)
+{
+	return (sim.result == SIM_DONE) && (stskrc == SYSERR);
+}
+
+struct	simtest	simtesttab[] = {
+	{ "sl_lock",	st_main_sl,		st_check_mutex },
+	{ "lock",	st_main_lock,		st_check_mutex },
+	{ "al_lock",	st_main_al,		st_check_mutex },
+	{ "pi_lock",	st_main_pi,		st_check_mutex },
+	{ "sl_irqsave",	st_main_slirq,		st_check_mutex },
+	{ "dwork",	st_main_dwork,		st_check_mutex },
+	{ "pi_inherit",	st_main_inherit,	st_check_inherit },
+	{ "al_deadlock", st_main_deadlock,	st_check_deadlock },
+	{ "al_abba",	st_main_abba,		st_check_abba },
+	{ "mixed_deadlock", st_main_mixed,	st_check_mixed },
+	{ "sem_kill",	st_main_semkill,	st_check_semkill },
+	{ "sem_delete",	st_main_semdel,		st_check_semdel },
+	{ "send_kill",	st_main_sendkill,	st_check_sendkill },
+	{ "dwork_kill",	st_main_dwkill,		st_check_dwkill },
+	{ NULL,		NULL,			NULL }
+};
+
+/*------------------------------------------------------------------------
+ *  sim_testname  -  Return the name of test i, or NULL past the end
+ *------------------------------------------------------------------------
+ */
+const char *sim_testname(
+	  int		i		/* Index into simtesttab	*/
+	)
+{
+	return simtesttab[i].stname;
+}
@@ -11,73 +11,12 @@
 #define DEBUG_MODE 0
 
 #define DEBUG_PRINT(fmt, ...) \
-            do { if (DEBUG_MODE) kprintf(fmt, ##__VA_ARGS__); } while (0)
+            do { if (DEBUG_MODE) klog(fmt, ##__VA_ARGS__); } while (0)
 
 static int al_count = 0;
 
 uint32 locks[NALOCKS] = {-1};
 
-void check_deadlock(pid32 curr_process, al_lock_t *l)
-{
-    int involved_processes[NALOCKS] = {-1};
-    int curr_lock_id = l->lock_id;
-    int iterator = curr_process;
-    int process_count = 0;
-
-    DEBUG_PRINT("Debug: Checking for deadlocks with process %d on lock %d\n", curr_process, l->lock_id);
-
-    while ((curr_lock_id != -1) && (iterator != -1))
-    {
-        involved_processes[process_count++] = iterator;
-        iterator = locks[curr_lock_id];
-
-        if (iterator == involved_processes[0])  // Deadlock detected
-        {
-            DEBUG_PRINT("Debug: Deadlock detected in process chain\n");
-
-            int i , j;
-            // Sort the process chain
-            for (i = 0; i < process_count; ++i)
-            {
-                for (j = i + 1; j < process_count; ++j)
-                {
-                    if (involved_processes[i] > involved_processes[j])
-                    {
-                        involved_processes[i] ^= involved_processes[j];
-                        involved_processes[j] ^= involved_processes[i];
-                        involved_processes[i] ^= involved_processes[j];
-                    }
-                }
-                /*int key = involved_processes[i];
-                int k = i - 1;
-
-                // Shift elements that are greater than `key` to one position ahead
-                while (k >= 0 && involved_processes[k] > key)
-                {
-                    involved_processes[k + 1] = involved_processes[k];
-                    k = k - 1;
-                }
-                involved_processes[k + 1] = key;*/
-            }
-
-            // Print deadlock chain
-            kprintf("deadlock_detected=");
-            for (j = 0; j < process_count; j++)
-            {
-                kprintf("P%d", involved_processes[j]);
-                if (j != (process_count - 1))
-                {
-                    kprintf("-");
-                }
-            }
-            kprintf("\n");
-            break;
-        }
-
-        curr_lock_id = proctab[iterator].pendingLockId;
-    }
-}
-
 syscall al_initlock(al_lock_t *l)
 {
     if (al_count >= NALOCKS)
@@ -90,6 +29,7 @@ syscall al_initlock(al_lock_t *l)
     l->guard = 0;
     l->lock_id = al_count++;
     l->queue = newqueue();
+    LS_REGISTER(l, LS_AL);
 
     DEBUG_PRINT("Debug: Initialized lock with ID %d\n", l->lock_id);
 
@@ -102,6 +42,8 @@ syscall al_lock(al_lock_t *l)
 
     while (test_and_set(&l->guard, 1))
     {
+        LS_SPIN(l);
+        LS_BACKOFF(l);
         sleepms(QUANTUM);
     }
 
@@ -110,17 +52,24 @@ syscall al_lock(al_lock_t *l)
         l->flag = 1;
         l->guard = 0;
         locks[l->lock_id] = currpid;
+        xtrace(XT_ACQUIRE | XTF_AL, currpid, l);
+        LS_ACQUIRE(l);
 
         DEBUG_PRINT("Debug: Process %d acquired lock %d\n", currpid, l->lock_id);
     }
     else 
     {
+        xtrace(XT_CONTEND | XTF_AL, currpid, l);
+        LS_CONTEND(l);
+        intmask mask = disable();  // No preemption while on l->queue but not parked
         proctab[currpid].pendingLockId = l->lock_id;
-        check_deadlock(currpid, l);
+        deadlock_check(currpid);  // Follows waits on any resource, not just al locks
         enqueue(currpid, l->queue);
         al_setpark();
         l->guard = 0;
         al_park();
+        restore(mask);
+        LS_ACQUIRE(l);  // al_unlock handed the lock to us
 
         DEBUG_PRINT("Debug: Process %d parked and waiting for lock %d\n", currpid, l->lock_id);
     }
@@ -134,9 +83,13 @@ syscall al_unlock(al_lock_t *l)
 
     while (test_and_set(&l->guard, 1))
     {
+        LS_SPIN(l);
+        LS_BACKOFF(l);
         sleepms(QUANTUM);
     }
 
+    xtrace(XT_RELEASE | XTF_AL, currpid, l);
+    LS_RELEASE(l);
     if (isempty(l->queue)) 
     {
         l->flag = 0;
@@ -148,6 +101,7 @@ syscall al_unlock(al_lock_t *l)
         pid32 processid = dequeue(l->queue);
         proctab[processid].pendingLockId = -1;
         locks[l->lock_id] = processid;
+        xtrace(XT_ACQUIRE | XTF_AL, processid, l);
         al_unpark(processid);
 
         DEBUG_PRINT("Debug: Lock %d passed to process %d\n", l->lock_id, processid);
@@ -164,6 +118,8 @@ bool8 al_trylock(al_lock_t *l)
 
     while (test_and_set(&l->guard, 1))
     {
+        LS_SPIN(l);
+        LS_BACKOFF(l);
         sleepms(QUANTUM);
     }
 
@@ -172,11 +128,15 @@ bool8 al_trylock(al_lock_t *l)
         l->flag = 1;
         l->guard = 0;
         locks[l->lock_id] = currpid;
+        xtrace(XT_ACQUIRE | XTF_AL, currpid, l);
+        LS_ACQUIRE(l);
+        proctab[currpid].prtryfail = 0;  // Ends a failure streak
         DEBUG_PRINT("Debug: Process %d successfully acquired lock %d\n", currpid, l->lock_id);
         return TRUE;
     }
 
     l->guard = 0;
+    proctab[currpid].prtryfail++;  // The watchdog samples the streak
     DEBUG_PRINT("Debug: Lock %d is already held, process %d could not acquire it\n", l->lock_id, currpid);
     return FALSE;
 }
@@ -198,8 +158,11 @@ syscall al_park()
 
     if (proctab[currpid].l_flag == TRUE) 
     {
+        uint64 parkstart = getticks();
+        xtrace(XT_PARK, currpid, 0);
         proctab[currpid].prstate = PR_WAIT;
         resched();
+        proctab[currpid].parktime += getticks() - parkstart;
     }
 
     restore(mask);
@@ -212,8 +175,9 @@ syscall al_park()
 syscall al_unpark(pid32 processid)
 {
     intmask mask = disable();
+    xtrace(XT_UNPARK, processid, 0);
     proctab[processid].prstate = PR_READY;
-    insert(processid, readylist, proctab[processid].prprio);
+    rq_insert(processid, proctab[processid].prprio);
     proctab[processid].l_flag = FALSE;
     restore(mask);
 
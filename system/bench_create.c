@@ -0,0 +1,81 @@
+/* bench_create.c - bench_create, bench_idler */
+
+#include <xinu.h>
+
+#define	BCSTK		1024		/* Stack size of helper procs	*/
+#define	BCPRIO		5		/* Priority of helper processes	*/
+
+local	process	bench_idler(void);
+
+/*------------------------------------------------------------------------
+ *  bench_create  -  Measure create and kill separately under churn
+ *		       while nlive other processes hold slots, so that the
+ *		       cost of finding a free ID shows up as NPROC fills
+ *------------------------------------------------------------------------
+ */
+process	bench_create(
+	  int32		nlive,		/* Processes kept alive		*/
+	  int32		iters		/* Create/kill pairs to time	*/
+	)
+{
+	static	pid32	live[NPROC];	/* IDs of the long-lived procs	*/
+	pid32	pid;			/* ID of the churned process	*/
+	uint64	t0, t1, t2;		/* Cycle counts			*/
+	uint64	tcreate, tkill;		/* Total cycles in each call	*/
+	int32	i, n, done;
+
+	if (iters <= 0) {
+		return SYSERR;
+	}
+
+	/* The long-lived processes block in receive and never run */
+
+	for (n = 0; n < nlive; n++) {
+		live[n] = create(bench_idler, BCSTK, BCPRIO, "idler", 0);
+		if (live[n] == SYSERR) {
+			break;
+		}
+		resume(live[n]);
+	}
+
+	tcreate = tkill = 0;
+	for (done = 0; done < iters; done++) {
+		t0 = getticks();
+		pid = create(bench_idler, BCSTK, BCPRIO, "churn", 0);
+		t1 = getticks();
+		if (pid == SYSERR) {
+			break;
+		}
+		kill(pid);
+		t2 = getticks();
+		recvclr();		/* Discard the exit notification*/
+		tcreate += t1 - t0;
+		tkill += t2 - t1;
+	}
+
+	for (i = 0; i < n; i++) {
+		kill(live[i]);
+		recvclr();
+	}
+
+	if (done == 0) {
+		done = 1;
+	}
+	kprintf("bench=create NPROC=%d live=%d iters=%d create=%u kill=%u "
+		"stkc_hits=%u stkc_misses=%u\n", NPROC, n, done,
+		(uint32)(tcreate / done), (uint32)(tkill / done),
+		stkchits, stkcmisses);
+	return OK;
+}
+
+/*------------------------------------------------------------------------
+ *  bench_idler  -  Occupy a process slot without using the CPU
+ *------------------------------------------------------------------------
+ */
+local	process	bench_idler(void)
+{
+	while (TRUE) {
+		receive();
+	}
+	return OK;
+}
@@ -0,0 +1,290 @@
+/* bench_lock.c - bench_lock, bench_waiter, bench_contender */
+
+#include <xinu.h>
+
+#define	BLSTK		4096		/* Stack size of helper procs	*/
+#define	BLPRIO		10		/* Priority of the contenders	*/
+#define	BLWINDOW	200		/* Contended run length in ms	*/
+#define	BLTHINKMAX	1024		/* Longest think, in loop steps	*/
+
+#ifndef	BLSEED
+#define	BLSEED		12345		/* Seed of the hold/think LCG	*/
+#endif
+
+#define	BLNKIND		4		/* Lock families under test	*/
+#define	BL_SL		0
+#define	BL_LOCK		1
+#define	BL_AL		2
+#define	BL_PI		3
+
+#ifdef	SLPREEMPT
+#define	BLPREEMPT	"on"		/* sl_lock holders preemptible	*/
+#else
+#define	BLPREEMPT	"off"
+#endif
+
+local	process	bench_waiter(int32, int32);
+local	process	bench_contender(int32, int32, int32);
+
+local	char	*blname[BLNKIND] = { "sl_lock", "lock", "al_lock", "pi_lock" };
+
+local	sl_lock_t	blsl;		/* One lock of each family	*/
+local	lock_t		bllk;
+local	al_lock_t	blal;
+local	pi_lock_t	blpi;
+
+local	uint64	blt0;			/* Cycle count at handoff	*/
+local	uint64	blhandoff;		/* Sum of handoff latencies	*/
+local	volatile bool8	blstop;		/* Contenders should finish	*/
+local	uint32	blcount[NPROC];		/* Acquisitions per contender	*/
+local	uint32	blcut[NPROC];		/* Holds cut by a switch	*/
+local	volatile uint32	blsink;		/* Keeps busy loops alive	*/
+
+/*------------------------------------------------------------------------
+ *  bl_acquire, bl_release  -  Operate on the lock of one family
+ *------------------------------------------------------------------------
+ */
+local	void	bl_acquire(
+	  int32		kind		/* Lock family (BL_*)		*/
+	)
+{
+	switch (kind) {
+	case BL_SL:	sl_lock(&blsl);		break;
+	case BL_LOCK:	lock(&bllk);		break;
+	case BL_AL:	al_lock(&blal);		break;
+	case BL_PI:	pi_lock(&blpi);		break;
+	}
+}
+
+local	void	bl_release(
+	  int32		kind		/* Lock family (BL_*)		*/
+	)
+{
+	switch (kind) {
+	case BL_SL:	sl_unlock(&blsl);	break;
+	case BL_LOCK:	unlock(&bllk);		break;
+	case BL_AL:	al_unlock(&blal);	break;
+	case BL_PI:	pi_unlock(&blpi);	break;
+	}
+}
+
+/*------------------------------------------------------------------------
+ *  bl_spin  -  Busy-loop for a pseudo-random number of steps below max,
+ *		  advancing the caller's LCG state
+ *------------------------------------------------------------------------
+ */
+local	void	bl_spin(
+	  uint32	*seed,		/* LCG state			*/
+	  uint32	max		/* Exclusive bound on steps	*/
+	)
+{
+	uint32	n;
+
+	*seed = *seed * 1103515245 + 12345;
+	for (n = (*seed >> 16) % max; n > 0; n--) {
+		blsink++;
+	}
+}
+
+/*------------------------------------------------------------------------
+ *  bench_lock  -  Measure each lock family: uncontended acquire and
+ *		     release, handoff from a releasing holder to a
+ *		     parked waiter, and throughput and fairness with 2 to
+ *		     nmax contenders.  Hold and think times come from a
+ *		     fixed-seed LCG so runs under QEMU are repeatable; one
+ *		     key=value line is printed per result.  Holds long
+ *		     enough for the timer to end a quantum inside them
+ *		     show up in holds_cut; build with -DSLPREEMPT to
+ *		     compare against preemptible sl_lock holders.
+ *------------------------------------------------------------------------
+ */
+process	bench_lock(
+	  int32		nmax,		/* Most contenders to run	*/
+	  int32		iters,		/* Iterations per measurement	*/
+	  int32		hold		/* Longest hold, in loop steps	*/
+	)
+{
+	static	bool8	lkinit = FALSE;	/* Locks are initialized once	*/
+	pid32	pids[NPROC];		/* Contender process IDs	*/
+	pid32	pid;			/* Waiter process ID		*/
+	uint64	start, elapsed;		/* Cycle counts			*/
+	uint64	sum, sumsq;		/* For Jain's fairness index	*/
+	uint32	total, cmin, cmax;	/* Acquisition counts		*/
+	uint32	cut;			/* Holds cut by a switch	*/
+	int32	kind, i, n, nproc;
+
+	if (iters <= 0) {
+		kprintf("bench_lock: iters must be positive\n");
+		return SYSERR;
+	}
+	if (hold <= 0) {
+		kprintf("bench_lock: hold must be positive\n");
+		return SYSERR;
+	}
+	if (getprio(getpid()) <= BLPRIO) {
+		kprintf("bench_lock: needs priority above %d\n", BLPRIO);
+		return SYSERR;
+	}
+	if (nmax >= NPROC) {
+		nmax = NPROC - 1;
+	}
+	if (!lkinit) {
+		if (sl_initlock(&blsl) == SYSERR || initlock(&bllk) == SYSERR
+		    || al_initlock(&blal) == SYSERR
+		    || pi_initlock(&blpi) == SYSERR) {
+			kprintf("bench_lock: cannot initialize locks\n");
+			return SYSERR;
+		}
+		lkinit = TRUE;
+	}
+
+	kprintf("bench=lock seed=%u iters=%d hold=%d window_ms=%d "
+		"preempt=%s\n", BLSEED, iters, hold, BLWINDOW, BLPREEMPT);
+
+	for (kind = 0; kind < BLNKIND; kind++) {
+
+		/* Uncontended acquire and release */
+
+		start = getticks();
+		for (i = 0; i < iters; i++) {
+			bl_acquire(kind);
+			bl_release(kind);
+		}
+		kprintf("bench=lock kind=%s test=uncontended cycles=%u\n",
+			blname[kind],
+			(uint32)((getticks() - start) / iters));
+
+		/* Handoff: a waiter above us parks on the lock while we	*/
+		/*   hold it, and times how long after our release it	*/
+		/*   returns from acquire.  A spinning waiter above us	*/
+		/*   would never let us release, so sl_lock is skipped.	*/
+
+		if (kind != BL_SL) {
+			blhandoff = 0;
+			pid = create(bench_waiter, BLSTK, getprio(getpid()) + 1,
+					"bl_waiter", 2, kind, iters);
+			if (pid == SYSERR) {
+				return SYSERR;
+			}
+			resume(pid);		/* Runs until its receive()	*/
+			for (i = 0; i < iters; i++) {
+				bl_acquire(kind);
+				send(pid, OK);	/* Waiter parks on the lock	*/
+				blt0 = getticks();
+				bl_release(kind);
+				receive();	/* Waiter has released it	*/
+			}
+			receive();		/* Waiter has exited		*/
+			kprintf("bench=lock kind=%s test=handoff cycles=%u\n",
+				blname[kind], (uint32)(blhandoff / iters));
+		}
+
+		/* Throughput and fairness with nproc equal-priority	*/
+		/*   contenders running for BLWINDOW ms			*/
+
+		for (nproc = 2; nproc <= nmax; nproc++) {
+			blstop = FALSE;
+			for (n = 0; n < nproc; n++) {
+				blcount[n] = 0;
+				blcut[n] = 0;
+				pids[n] = create(bench_contender, BLSTK, BLPRIO,
+						"bl_contend", 3, kind, n, hold);
+				if (pids[n] == SYSERR) {
+					break;
+				}
+			}
+			start = getticks();
+			for (i = 0; i < n; i++) {
+				resume(pids[i]);
+			}
+			sleepms(BLWINDOW);
+			blstop = TRUE;
+			for (i = 0; i < n; i++) {
+				receive();
+			}
+			elapsed = getticks() - start;
+
+			total = cut = 0;
+			cmin = cmax = blcount[0];
+			sumsq = 0;
+			for (i = 0; i < n; i++) {
+				total += blcount[i];
+				cut += blcut[i];
+				sumsq += (uint64)blcount[i] * blcount[i];
+				if (blcount[i] < cmin) {
+					cmin = blcount[i];
+				}
+				if (blcount[i] > cmax) {
+					cmax = blcount[i];
+				}
+			}
+			sum = total;
+
+			/* Jain's index, in thousandths: 1000 is perfectly	*/
+			/*   even, 1000/n means one process got everything	*/
+
+			kprintf("bench=lock kind=%s test=contended nproc=%d "
+				"acquires=%u cycles_per_acquire=%u min=%u "
+				"max=%u jain=%u holds_cut=%u\n", blname[kind],
+				n, total,
+				(uint32)(elapsed / (total ? total : 1)), cmin,
+				cmax, (sumsq == 0) ? 0 :
+				(uint32)(sum * sum * 1000 / (n * sumsq)), cut);
+		}
+	}
+	return OK;
+}
+
+/*------------------------------------------------------------------------
+ *  bench_waiter  -  Each time bench_lock holds the lock, park on it and
+ *		       add the time from its release to our acquire
+ *------------------------------------------------------------------------
+ */
+local	process	bench_waiter(
+	  int32		kind,		/* Lock family (BL_*)		*/
+	  int32		rounds		/* Number of handoffs		*/
+	)
+{
+	pid32	parent = proctab[getpid()].prparent;
+	int32	i;
+
+	for (i = 0; i < rounds; i++) {
+		receive();
+		bl_acquire(kind);
+		blhandoff += getticks() - blt0;
+		bl_release(kind);
+		send(parent, OK);
+	}
+	return OK;
+}
+
+/*------------------------------------------------------------------------
+ *  bench_contender  -  Acquire, hold, release, and think until told to
+ *			  stop, counting acquisitions and holds that a
+ *			  context switch landed in
+ *------------------------------------------------------------------------
+ */
+local	process	bench_contender(
+	  int32		kind,		/* Lock family (BL_*)		*/
+	  int32		slot,		/* Index into blcount		*/
+	  int32		hold		/* Longest hold, in loop steps	*/
+	)
+{
+	struct	procent	*prptr;		/* Our process table entry	*/
+	uint32	seed = BLSEED + slot;	/* Same sequence every run	*/
+	uint32	nsw;			/* Switches before the hold	*/
+
+	prptr = &proctab[getpid()];
+	while (!blstop) {
+		bl_acquire(kind);
+		nsw = prptr->num_invsw;
+		bl_spin(&seed, hold);
+		if (prptr->num_invsw != nsw) {
+			blcut[slot]++;
+		}
+		blcount[slot]++;
+		bl_release(kind);
+		bl_spin(&seed, BLTHINKMAX);
+	}
+	return OK;
+}
@@ -0,0 +1,129 @@
+/* bench_nproc.c - bench_nproc, bench_filler, bench_pingpong */
+
+#include <xinu.h>
+
+#define	BNSTK		1024		/* Stack size of helper procs	*/
+#define	BNFILLPRIO	5		/* Priority of filler processes	*/
+#define	BNPINGPRIO	10		/* Priority of yielding pair	*/
+
+local	process	bench_filler(void);
+local	process	bench_pingpong(int32);
+
+/*------------------------------------------------------------------------
+ *  bench_nproc  -  Measure create, lock, and resched costs while nlive
+ *		      other processes occupy the process table; the
+ *		      numbers should not move as NPROC or nlive grow
+ *------------------------------------------------------------------------
+ */
+process	bench_nproc(
+	  int32		nlive,		/* Filler processes to create	*/
+	  int32		iters		/* Iterations per measurement	*/
+	)
+{
+	static	pid32	fill[NPROC];	/* Filler process IDs		*/
+	static	lock_t	lk;		/* Lock for the lock timings	*/
+	static	pi_lock_t plk;		/* PI lock for the lock timings	*/
+	static	bool8	lkinit = FALSE;	/* Locks are initialized once	*/
+	pid32	pid;			/* Scratch process ID		*/
+	uint64	start;			/* Cycle count at start		*/
+	uint32	tcreate, tlock, tpilock, tsched;
+	int32	i, n;
+
+	if (getprio(getpid()) <= BNPINGPRIO || iters <= 0) {
+		kprintf("bench_nproc: needs priority above %d\n", BNPINGPRIO);
+		return SYSERR;
+	}
+	if (!lkinit) {
+		if (initlock(&lk) == SYSERR || pi_initlock(&plk) == SYSERR) {
+			return SYSERR;
+		}
+		lkinit = TRUE;
+	}
+
+	/* Fill the table with ready processes below our priority */
+
+	for (n = 0; n < nlive; n++) {
+		fill[n] = create(bench_filler, BNSTK, BNFILLPRIO, "filler", 0);
+		if (fill[n] == SYSERR) {
+			break;
+		}
+		resume(fill[n]);
+	}
+
+	/* Cost of creating and killing one process */
+
+	start = getticks();
+	for (i = 0; i < iters; i++) {
+		pid = create(bench_filler, BNSTK, BNFILLPRIO, "churn", 0);
+		if (pid == SYSERR) {
+			break;
+		}
+		kill(pid);
+		recvclr();		/* Discard the exit notification*/
+	}
+	tcreate = (uint32)((getticks() - start) / iters);
+
+	/* Cost of an uncontended acquire and release */
+
+	start = getticks();
+	for (i = 0; i < iters; i++) {
+		lock(&lk);
+		unlock(&lk);
+	}
+	tlock = (uint32)((getticks() - start) / iters);
+
+	start = getticks();
+	for (i = 0; i < iters; i++) {
+		pi_lock(&plk);
+		pi_unlock(&plk);
+	}
+	tpilock = (uint32)((getticks() - start) / iters);
+
+	/* Cost of one context switch between a pair of processes; we	*/
+	/*   block until kill reports that both have finished		*/
+
+	resume(create(bench_pingpong, BNSTK, BNPINGPRIO, "ping", 1, iters));
+	resume(create(bench_pingpong, BNSTK, BNPINGPRIO, "pong", 1, iters));
+	start = getticks();
+	receive();
+	receive();
+	tsched = (uint32)((getticks() - start) / (2 * iters));
+
+	for (i = 0; i < n; i++) {
+		kill(fill[i]);
+		recvclr();
+	}
+
+	kprintf("bench=nproc NPROC=%d live=%d create_kill=%u lock=%u "
+		"pi_lock=%u resched=%u\n", NPROC, n, tcreate, tlock,
+		tpilock, tsched);
+	return OK;
+}
+
+/*------------------------------------------------------------------------
+ *  bench_filler  -  Stay ready without ever getting the CPU
+ *------------------------------------------------------------------------
+ */
+local	process	bench_filler(void)
+{
+	while (TRUE) {
+		yield();
+	}
+	return OK;
+}
+
+/*------------------------------------------------------------------------
+ *  bench_pingpong  -  Yield to the other member of the pair
+ *------------------------------------------------------------------------
+ */
+local	process	bench_pingpong(
+	  int32		rounds		/* Number of yields		*/
+	)
+{
+	int32	i;
+
+	for (i = 0; i < rounds; i++) {
+		yield();
+	}
+	return OK;
+}
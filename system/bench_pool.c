@@ -0,0 +1,91 @@
+/* bench_pool.c - bench_pool, bench_task, bench_taskproc */
+
+#include <xinu.h>
+
+#define	BPSTK		8192		/* Stack of a per-task process	*/
+#define	BPPRIO		10		/* Priority of workers/tasks	*/
+
+local	void	bench_task(void *);
+local	process	bench_taskproc(void *);
+
+local	uint32	bench_ntask;		/* Tasks that have run		*/
+
+/*------------------------------------------------------------------------
+ *  bench_pool  -  Compare running ntasks short tasks as one process
+ *		     each against running them on a pool of nwork workers
+ *------------------------------------------------------------------------
+ */
+process	bench_pool(
+	  int32		nwork,		/* Workers in the pool		*/
+	  int32		ntasks		/* Tasks to run each way	*/
+	)
+{
+	pid32	pid;			/* Per-task process		*/
+	int32	pool;			/* Pool under test		*/
+	uint64	start;			/* Cycle count at start		*/
+	uint32	tproc, tpool;		/* Cycles per task		*/
+	int32	i;
+
+	if (getprio(getpid()) <= BPPRIO || ntasks <= 0) {
+		kprintf("bench_pool: needs priority above %d\n", BPPRIO);
+		return SYSERR;
+	}
+
+	/* One process per task; kill reports each one finishing */
+
+	bench_ntask = 0;
+	start = getticks();
+	for (i = 0; i < ntasks; i++) {
+		pid = create(bench_taskproc, BPSTK, BPPRIO, "task", 1, NULL);
+		if (pid == SYSERR) {
+			break;
+		}
+		resume(pid);
+		receive();
+	}
+	tproc = (uint32)((getticks() - start) / ntasks);
+
+	/* The same tasks on the pool */
+
+	if ((pool = pool_create(nwork, BPPRIO)) == SYSERR) {
+		kprintf("bench_pool: cannot create pool\n");
+		return SYSERR;
+	}
+	bench_ntask = 0;
+	start = getticks();
+	for (i = 0; i < ntasks; i++) {
+		pool_submit(pool, bench_task, NULL);
+	}
+	pool_wait(pool);
+	tpool = (uint32)((getticks() - start) / ntasks);
+	pool_delete(pool);
+	recvclr();			/* Discard worker exit notices	*/
+
+	kprintf("bench=pool workers=%d tasks=%d per_process=%u "
+		"per_pool_task=%u ran=%u\n", nwork, ntasks, tproc, tpool,
+		bench_ntask);
+	return OK;
+}
+
+/*------------------------------------------------------------------------
+ *  bench_task  -  A short unit of work
+ *------------------------------------------------------------------------
+ */
+local	void	bench_task(
+	  void		*arg		/* Unused			*/
+	)
+{
+	bench_ntask++;
+}
+
+/*------------------------------------------------------------------------
+ *  bench_taskproc  -  Run one task as a process of its own
+ *------------------------------------------------------------------------
+ */
+local	process	bench_taskproc(
+	  void		*arg		/* Passed to the task		*/
+	)
+{
+	bench_task(arg);
+	return OK;
+}
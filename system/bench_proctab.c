@@ -0,0 +1,145 @@
+/* bench_proctab.c - bench_proctab, bench_parker, bench_chainlink,	*/
+/*			bench_chainend					*/
+
+#include <xinu.h>
+
+#define	BPSTK		2048		/* Stack size of helper procs	*/
+
+local	process	bench_parker(int32);
+local	process	bench_chainlink(al_lock_t *, al_lock_t *);
+local	process	bench_chainend(al_lock_t *);
+
+/*------------------------------------------------------------------------
+ *  bench_proctab  -  Measure the process table paths that the layout
+ *			of struct procent affects: a park/unpark round
+ *			trip and a walk of a chain of waiting processes
+ *------------------------------------------------------------------------
+ */
+process	bench_proctab(
+	  int32		chainlen,	/* Processes in the wait chain	*/
+	  int32		iters		/* Iterations per measurement	*/
+	)
+{
+	static	al_lock_t chain[NALOCKS];/* Locks forming the chain	*/
+	static	int32	nchain = 0;	/* Locks initialized so far	*/
+	pid32	parker;			/* Process that parks		*/
+	pid32	end;			/* Holder at the end of chain	*/
+	pri16	prio;			/* Priority of this process	*/
+	uint64	start;			/* Cycle count at start		*/
+	uint32	tpark, twalk;
+	int32	i;
+
+	if (iters <= 0) {
+		return SYSERR;
+	}
+	if (chainlen > NALOCKS - 1) {
+		chainlen = NALOCKS - 1;
+	}
+	prio = getprio(getpid());
+
+	/* Helpers run at our priority, so resuming one runs it until	*/
+	/*   it blocks, and kill notifies us as each one finishes	*/
+
+	/* Park/unpark: each unpark and yield hands the parker the CPU	*/
+	/*   until it parks again					*/
+
+	parker = create(bench_parker, BPSTK, prio, "parker", 1, iters);
+	resume(parker);
+	start = getticks();
+	for (i = 0; i < iters; i++) {
+		unpark(parker);
+		yield();
+	}
+	tpark = (uint32)((getticks() - start) / iters);
+	receive();
+
+	/* Build chain[0] <- P0 <- chain[1] <- ... <- chain[chainlen],	*/
+	/*   the last lock held by a process that is not waiting	*/
+
+	while (nchain <= chainlen) {
+		if (al_initlock(&chain[nchain]) == SYSERR) {
+			break;
+		}
+		nchain++;
+	}
+	if (chainlen >= nchain) {
+		chainlen = nchain - 1;
+	}
+	end = create(bench_chainend, BPSTK, prio, "chainend", 1,
+			&chain[chainlen]);
+	resume(end);
+	for (i = chainlen - 1; i >= 0; i--) {
+		resume(create(bench_chainlink, BPSTK, prio, "chainlink", 2,
+			&chain[i], &chain[i + 1]));
+	}
+
+	/* Walk as a process about to wait on chain[0] would */
+
+	proctab[currpid].pendingLockId = chain[0].lock_id;
+	start = getticks();
+	for (i = 0; i < iters; i++) {
+		deadlock_check(currpid);
+	}
+	twalk = (uint32)((getticks() - start) / iters);
+	proctab[currpid].pendingLockId = -1;
+
+	/* Let the chain unwind one handoff at a time */
+
+	send(end, OK);
+	for (i = 0; i <= chainlen; i++) {
+		receive();
+	}
+
+	kprintf("bench=proctab entry=%d park_unpark=%u chain=%d "
+		"chain_walk=%u\n", sizeof(struct procent), tpark,
+		chainlen, twalk);
+	return OK;
+}
+
+/*------------------------------------------------------------------------
+ *  bench_parker  -  Park repeatedly, waiting to be unparked each time
+ *------------------------------------------------------------------------
+ */
+local	process	bench_parker(
+	  int32		rounds		/* Number of times to park	*/
+	)
+{
+	int32	i;
+
+	for (i = 0; i < rounds; i++) {
+		setpark();
+		park();
+	}
+	return OK;
+}
+
+/*------------------------------------------------------------------------
+ *  bench_chainlink  -  Hold one lock while waiting for the next
+ *------------------------------------------------------------------------
+ */
+local	process	bench_chainlink(
+	  al_lock_t	*mine,		/* Lock held while waiting	*/
+	  al_lock_t	*next		/* Lock waited for		*/
+	)
+{
+	al_lock(mine);
+	al_lock(next);
+	al_unlock(next);
+	al_unlock(mine);
+	return OK;
+}
+
+/*------------------------------------------------------------------------
+ *  bench_chainend  -  Hold the last lock of the chain until told to
+ *			 release it
+ *------------------------------------------------------------------------
+ */
+local	process	bench_chainend(
+	  al_lock_t	*last		/* Lock at the end of the chain	*/
+	)
+{
+	al_lock(last);
+	receive();
+	al_unlock(last);
+	return OK;
+}
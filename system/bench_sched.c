@@ -0,0 +1,74 @@
+/* bench_sched.c - bench_sched, bench_yielder */
+
+#include <xinu.h>
+
+#define	BSSTK		4096		/* Stack size of each yielder	*/
+#define	BSPRIO		10		/* Priority of the yielders	*/
+
+local	process	bench_yielder(int32);
+
+/*------------------------------------------------------------------------
+ *  bench_sched  -  Measure the cost of a context switch when nready
+ *		      processes are all ready at the same priority, which
+ *		      is the worst case for an ordered ready list
+ *------------------------------------------------------------------------
+ */
+process	bench_sched(
+	  int32		nready,		/* Number of ready processes	*/
+	  int32		rounds		/* Yields done by each process	*/
+	)
+{
+	pid32	pids[NPROC];		/* Yielder process IDs		*/
+	uint64	start, elapsed;		/* Cycle counts			*/
+	uint32	nswitch;		/* Total switches measured	*/
+	int32	i, n;
+
+	if (getprio(getpid()) <= BSPRIO) {
+		kprintf("bench_sched: must run above priority %d\n", BSPRIO);
+		return SYSERR;
+	}
+
+	for (n = 0; n < nready && n < NPROC; n++) {
+		pids[n] = create(bench_yielder, BSSTK, BSPRIO, "yielder",
+				1, rounds);
+		if (pids[n] == SYSERR) {
+			break;
+		}
+	}
+
+	/* The yielders are below us, so they only run once we block;	*/
+	/*   kill tells us as each one finishes				*/
+
+	start = getticks();
+	for (i = 0; i < n; i++) {
+		resume(pids[i]);
+	}
+	for (i = 0; i < n; i++) {
+		receive();
+	}
+	elapsed = getticks() - start;
+
+	nswitch = (uint32)n * (uint32)rounds;
+	if (nswitch == 0) {
+		nswitch = 1;
+	}
+	kprintf("bench=resched nready=%d switches=%u cycles_per_switch=%u\n",
+		n, nswitch, (uint32)(elapsed / nswitch));
+	return OK;
+}
+
+/*------------------------------------------------------------------------
+ *  bench_yielder  -  Give up the CPU a fixed number of times
+ *------------------------------------------------------------------------
+ */
+local	process	bench_yielder(
+	  int32		rounds		/* Number of yields		*/
+	)
+{
+	int32	i;
+
+	for (i = 0; i < rounds; i++) {
+		yield();
+	}
+	return OK;
+}
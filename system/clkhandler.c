@@ -1,45 +1,78 @@
-/* clkhandler.c - clkhandler */
+/* clkhandler.c - clkhandler, clkadvance, clkwake, clkwakeup */
 
 #include <xinu.h>
 
+uint32	count1000 = 1000;		/* Count to 1000 ms		*/
+local	bool8	clkwakepend = FALSE;	/* A wakeup is queued in dwork	*/
+
 /*------------------------------------------------------------------------
- * clkhandler - high level clock interrupt handler
+ * clkwakeup - deferred-work item that awakens expired processes
  *------------------------------------------------------------------------
  */
-void	clkhandler()
+local	void	clkwakeup(
+	  uint32	arg		/* Unused			*/
+	)
 {
-	static	uint32	count1000 = 1000;	/* Count to 1000 ms	*/
-
-	/* update runtime of the current process */
-
-	proctab[currpid].runtime++;
+	intmask	mask;			/* Saved interrupt mask		*/
 
-	/* update the ms counter (32 bits are enough for practical purposes) */
-
-	ctr1000++;
-
-	/* Decrement the ms counter, and see if a second has passed */
-	if((--count1000) <= 0) {
+	mask = disable();
+	clkwakepend = FALSE;
+	wakeup();
+	restore(mask);
+}
 
-		/* One second has passed, so increment seconds count */
+/*------------------------------------------------------------------------
+ * clkwake - awaken processes whose timers have expired, from the
+ *	       deferred-work process if it is running; ticks that expire
+ *	       timers before it gets to the first are covered by the same
+ *	       wakeup
+ *------------------------------------------------------------------------
+ */
+local	void	clkwake(void)
+{
+	if (clkwakepend) {
+		return;
+	}
+	if (dwork(clkwakeup, 0) == OK) {
+		clkwakepend = TRUE;
+	} else {
+		wakeup();
+	}
+}
 
-		clktime++;
+/*------------------------------------------------------------------------
+ * clkhandler - high level clock interrupt handler; rescheduling is
+ *		  deferred until it ends, so a process it makes ready
+ *		  (the deferred-work process included) is switched in
+ *		  once, after the handler's own work is done
+ *------------------------------------------------------------------------
+ */
+void	clkhandler()
+{
+	resched_cntl(DEFER_START);
 
-		/* Reset the local ms counter for the next second */
+#ifdef	TICKLESS
+	/* An idle one-shot period has ended; catch up on the ticks it	*/
+	/*   covered and go back to periodic ticks			*/
 
-		count1000 = 1000;
+	if(clkoneshot != 0) {
+		if(clkadvance(clkperiodic())) {
+			clkwake();
+		}
+		resched_cntl(DEFER_STOP);
+		return;
 	}
+#endif
 
-	/* Handle sleeping processes if any exist */
+	/* update runtime of the current process */
 
-	if(!isempty(sleepq)) {
+	proctab[currpid].runtime++;
 
-		/* Decrement the delay for the first process on the	*/
-		/*   sleep queue, and awaken if the count reaches zero	*/
+	/* Advance the clock and the timing wheel, and awaken processes */
+	/*   whose timers have expired					*/
 
-		if((--queuetab[firstid(sleepq)].qkey) <= 0) {
-			wakeup();
-		}
+	if(clkadvance(1)) {
+		clkwake();
 	}
 
 	/* Decrement the preemption counter, and reschedule when the */
@@ -49,4 +82,42 @@ void	clkhandler()
 		preempt = QUANTUM;
 		resched();
 	}
+
+	resched_cntl(DEFER_STOP);
+}
+
+/*------------------------------------------------------------------------
+ * clkadvance - account for nticks elapsed clock ticks; returns TRUE if
+ *		  any process timers have expired (interrupts disabled)
+ *------------------------------------------------------------------------
+ */
+bool8	clkadvance(
+	  uint32	nticks		/* Ticks that have elapsed	*/
+	)
+{
+	bool8	expired = FALSE;	/* Did any timer expire?	*/
+
+	while(nticks-- > 0) {
+
+		/* update the ms counter (32 bits are enough for practical purposes) */
+
+		ctr1000++;
+
+		/* Decrement the ms counter, and see if a second has passed */
+		if((--count1000) <= 0) {
+
+			/* One second has passed, so increment seconds count */
+
+			clktime++;
+
+			/* Reset the local ms counter for the next second */
+
+			count1000 = 1000;
+		}
+
+		if(tw_tick()) {
+			expired = TRUE;
+		}
+	}
+	return expired;
 }
@@ -0,0 +1,134 @@
+/* clkidle.c - clkidle, clkperiodic, clksync, clkread */
+
+#include <xinu.h>
+
+#ifdef	TICKLESS
+
+/* In a TICKLESS build the clock still ticks every millisecond while	*/
+/*   any process other than the null process can run.  When nothing is	*/
+/*   ready, clkidle switches the 8254 to a one-shot that covers the	*/
+/*   whole idle period (up to the next timer on the wheel) and halts;	*/
+/*   the ticks that were skipped are credited when the one-shot fires	*/
+/*   or when something else wakes the system first.			*/
+
+#define	PIC1CMD		0x20		/* Master 8259 command port	*/
+#define	PICREADIRR	0x0a		/* OCW3: read request register	*/
+
+uint32	clkoneshot = 0;			/* Ticks in the armed one-shot	*/
+local	uint32	clkresid = 0;		/* 8254 counts short of a tick	*/
+
+/*------------------------------------------------------------------------
+ * clkread - latch and read counter 0, reporting whether its output
+ *	       has gone high (a mode 0 one-shot has reached zero)
+ *------------------------------------------------------------------------
+ */
+local	uint32	clkread(
+	  bool8		*fired		/* Set TRUE if output is high	*/
+	)
+{
+	uint32	status, lo, hi;
+
+	outb(CLKCNTL, 0xc2);		/* Read-back status and count	*/
+	status = inb(CLOCK0) & 0xff;
+	lo = inb(CLOCK0) & 0xff;
+	hi = inb(CLOCK0) & 0xff;
+	*fired = (status & 0x80) != 0;
+	return (hi << 8) | lo;
+}
+
+/*------------------------------------------------------------------------
+ * clkidle - called from the null process loop; if no process is ready,
+ *	       replace the periodic tick with a one-shot that lasts until
+ *	       the wheel next needs attention, then halt until any
+ *	       interrupt arrives
+ *------------------------------------------------------------------------
+ */
+void	clkidle(void)
+{
+	intmask	mask;			/* Saved interrupt mask		*/
+	uint32	nticks;			/* Length of the idle period	*/
+	uint32	count;			/* 8254 count for the one-shot	*/
+	bool8	fired;
+
+	mask = disable();
+
+	/* Do not arm while a tick is already waiting to be handled */
+
+	outb(PIC1CMD, PICREADIRR);
+	if (rqisempty() && (clkoneshot == 0) && !(inb(PIC1CMD) & 0x01)) {
+		nticks = tw_idle(CLKMAXIDLE);
+		if (nticks > 1) {
+
+			/* Credit the part of this tick already gone */
+
+			clkresid += CLKCOUNTS - clkread(&fired);
+			count = nticks * CLKCOUNTS;
+			outb(CLKCNTL, 0x30);	/* Counter 0, mode 0	*/
+			outb(CLOCK0, (char) (0xff & count));
+			outb(CLOCK0, (char) (0xff & (count >> 8)));
+			clkoneshot = nticks;
+		}
+	}
+
+	/* sti only takes effect after the next instruction, so no	*/
+	/*   interrupt can slip in between it and the halt		*/
+
+	asm volatile ("sti; hlt");
+	restore(mask);
+}
+
+/*------------------------------------------------------------------------
+ * clkperiodic - end a one-shot period, put the 8254 back in 1 ms rate
+ *		   generator mode, and return the whole ticks that passed
+ *		   (interrupts disabled)
+ *------------------------------------------------------------------------
+ */
+uint32	clkperiodic(void)
+{
+	uint32	armed;			/* Counts in the one-shot	*/
+	uint32	left;			/* Counts it had remaining	*/
+	uint32	nticks;
+	bool8	fired;
+
+	armed = clkoneshot * CLKCOUNTS;
+	left = clkread(&fired);
+	if (fired || (left > armed)) {
+		left = 0;
+	}
+	clkresid += armed - left;
+	nticks = clkresid / CLKCOUNTS;
+	clkresid %= CLKCOUNTS;
+
+	outb(CLKCNTL, 0x34);		/* Counter 0, mode 2		*/
+	outb(CLOCK0, (char) (0xff & CLKCOUNTS));
+	outb(CLOCK0, (char) (0xff & (CLKCOUNTS >> 8)));
+	clkoneshot = 0;
+	return nticks;
+}
+
+/*------------------------------------------------------------------------
+ * clksync - bring ctr1000, clktime, and the wheel up to date when the
+ *	       system leaves an idle period early, and resume periodic
+ *	       ticks; timers found due are awakened on the next tick
+ *------------------------------------------------------------------------
+ */
+void	clksync(void)
+{
+	intmask	mask;			/* Saved interrupt mask		*/
+	bool8	fired;
+
+	mask = disable();
+	if (clkoneshot != 0) {
+
+		/* If the one-shot already fired, its interrupt is	*/
+		/*   pending and clkhandler will do the accounting	*/
+
+		clkread(&fired);
+		if (!fired) {
+			clkadvance(clkperiodic());
+		}
+	}
+	restore(mask);
+}
+
+#endif
@@ -1,9 +1,23 @@
-/* create.c - create, newpid */
+/* create.c - create, newpid, freepid */
 
 #include <xinu.h>
 
 local int newpid();
 
+/* Free process IDs are kept as a bitmap with a summary word per 32	*/
+/*   bitmap words, so finding the next free ID touches at most a few	*/
+/*   words.  IDs are handed out round-robin from pidnext, as the scan	*/
+/*   used to do, so a freed ID is not reused at once.			*/
+
+#define	PIDNWORD	((NPROC + 31) / 32)	/* Bitmap words		*/
+#define	PIDNSUM		((PIDNWORD + 31) / 32)	/* Summary words	*/
+
+local	uint32	pidbits[PIDNWORD];	/* Bit set iff that ID is free	*/
+local	uint32	pidsum[PIDNSUM];	/* Bit set iff pidbits word has	*/
+					/*   a free ID			*/
+local	pid32	pidnext = 0;		/* Where the next search starts	*/
+local	bool8	pidinit = FALSE;	/* Has the bitmap been filled?	*/
+
 /*------------------------------------------------------------------------
  *  create  -  Create a process to start running a function on x86
  *------------------------------------------------------------------------
@@ -29,8 +43,12 @@ pid32	create(
 	if (ssize < MINSTK)
 		ssize = MINSTK;
 	ssize = (uint32) roundmb(ssize);
-	if ( (priority < 1) || ((pid=newpid()) == SYSERR) ||
-	     ((saddr = (uint32 *)getstk(ssize)) == (uint32 *)SYSERR) ) {
+	if ( (priority < 1) || ((pid=newpid()) == SYSERR) ) {
+		restore(mask);
+		return SYSERR;
+	}
+	if ((saddr = (uint32 *)stkcget(ssize)) == (uint32 *)SYSERR) {
+		freepid(pid);		/* newpid marked the ID in use	*/
 		restore(mask);
 		return SYSERR;
 	}
@@ -47,20 +65,44 @@ pid32	create(
 	for (i=0 ; i<PNMLEN-1 && (prptr->prname[i]=name[i])!=NULLCH; i++)
 		;
 	prptr->prsem = -1;
+	prptr->prmutex = -1;
 	prptr->prparent = (pid32)getpid();
-	prptr->prhasmsg = FALSE;
+	prptr->prmbhead = 0;
+	prptr->prmbcount = 0;
 	//prptr->user_process = FALSE;
 	prptr->runtime = 0;
 	prptr->l_flag = FALSE;
 	prptr->pendingLockId = -1;
 	prptr->priority = 0;
 	prptr->pendingLock = NULL;
+	prptr->piheld = NULL;
+	prptr->prspinon = NULL;
+	prptr->prtryfail = 0;
+	prptr->prnopreempt = 0;
+	prptr->prpreemptpend = FALSE;
+	prptr->num_ctxsw = 0;
+	prptr->num_volsw = 0;
+	prptr->num_invsw = 0;
+	prptr->cputime = 0;
+	prptr->parktime = 0;
+	prptr->swintime = 0;
+	prptr->starttime = getticks();
+	prptr->prentry = funcaddr;
 
 	/* Set up stdin, stdout, and stderr descriptors for the shell	*/
 	prptr->prdesc[0] = CONSOLE;
 	prptr->prdesc[1] = CONSOLE;
 	prptr->prdesc[2] = CONSOLE;
 
+#ifdef	STKPAINT
+	/* Paint the stack so stkuse can find its high-water mark	*/
+
+	for (a = (uint32 *)((uint32)saddr - ssize + sizeof(uint32));
+	     a < saddr; a++) {
+		*a = STKPATTERN;
+	}
+#endif
+
 	/* Initialize stack as if the process was called		*/
 
 	*saddr = STACKMAGIC;
@@ -104,24 +146,113 @@ pid32	create(
 }
 
 /*------------------------------------------------------------------------
- *  newpid  -  Obtain a new (free) process ID
+ *  pidbsf  -  Index of the least significant set bit in a nonzero word
+ *------------------------------------------------------------------------
+ */
+local	inline	uint32	pidbsf(
+	  uint32	w		/* Word to scan (nonzero)	*/
+	)
+{
+	uint32	r;
+
+	asm ("bsfl %1, %0" : "=r" (r) : "rm" (w));
+	return r;
+}
+
+/*------------------------------------------------------------------------
+ *  pidsetfree  -  Mark a process ID free or in use in the bitmap
+ *------------------------------------------------------------------------
+ */
+local	void	pidsetfree(
+	  pid32		pid,		/* ID to mark			*/
+	  bool8		isfree		/* TRUE if the ID is now free	*/
+	)
+{
+	int32	w = pid >> 5;		/* Bitmap word holding the ID	*/
+
+	if (isfree) {
+		pidbits[w] |= 1 << (pid & 0x1f);
+		pidsum[w >> 5] |= 1 << (w & 0x1f);
+	} else {
+		pidbits[w] &= ~(1 << (pid & 0x1f));
+		if (pidbits[w] == 0) {
+			pidsum[w >> 5] &= ~(1 << (w & 0x1f));
+		}
+	}
+}
+
+/*------------------------------------------------------------------------
+ *  pidscan  -  Return the first bitmap word at or after w that has a
+ *		  free ID, or -1 if there is none
+ *------------------------------------------------------------------------
+ */
+local	int32	pidscan(
+	  int32		w		/* First bitmap word to consider*/
+	)
+{
+	int32	s;			/* Summary word index		*/
+	uint32	bits;			/* Candidate summary bits	*/
+
+	for (s = w >> 5; s < PIDNSUM; s++) {
+		bits = pidsum[s];
+		if (s == (w >> 5)) {
+			bits &= ~0U << (w & 0x1f);
+		}
+		if (bits != 0) {
+			return (s << 5) + pidbsf(bits);
+		}
+	}
+	return -1;
+}
+
+/*------------------------------------------------------------------------
+ *  newpid  -  Obtain a new (free) process ID in constant time
  *------------------------------------------------------------------------
  */
 local pid32	newpid(void)
 {
-	uint32	i;			/* Iterate through all processes*/
-	static	pid32 nextpid = 1;	/* Position in table to try or	*/
-					/*   one beyond end of table	*/
-
-	/* Check all NPROC slots */
-
-	for (i = 0; i < NPROC; i++) {
-		nextpid %= NPROC;	/* Wrap around to beginning */
-		if (proctab[nextpid].prstate == PR_FREE) {
-			return nextpid++;
-		} else {
-			nextpid++;
+	pid32	pid;			/* Process ID to return		*/
+	int32	w;			/* Bitmap word being searched	*/
+	uint32	bits;			/* Free IDs in that word	*/
+
+	/* The first call collects the slots left free at boot; from	*/
+	/*   then on create and kill keep the bitmap up to date		*/
+
+	if (!pidinit) {
+		for (pid = 0; pid < NPROC; pid++) {
+			if (proctab[pid].prstate == PR_FREE) {
+				pidsetfree(pid, TRUE);
+			}
 		}
+		pidinit = TRUE;
+	}
+
+	/* Take the first free ID at or after pidnext, wrapping once */
+
+	w = pidnext >> 5;
+	bits = pidbits[w] & (~0U << (pidnext & 0x1f));
+	if (bits == 0) {
+		if ((w = pidscan(w + 1)) < 0 && (w = pidscan(0)) < 0) {
+			return (pid32) SYSERR;
+		}
+		bits = pidbits[w];
+	}
+	pid = (w << 5) + pidbsf(bits);
+	pidsetfree(pid, FALSE);
+	pidnext = (pid + 1 < NPROC) ? pid + 1 : 0;
+	return pid;
+}
+
+/*------------------------------------------------------------------------
+ *  freepid  -  Return the ID of a terminated process to the free bitmap
+ *		  (assumes interrupts are disabled)
+ *------------------------------------------------------------------------
+ */
+void	freepid(
+	  pid32		pid		/* ID of process being freed	*/
+	)
+{
+	if (pidinit) {
+		pidsetfree(pid, TRUE);
 	}
-	return (pid32) SYSERR;
 }
@@ -0,0 +1,153 @@
+/* deadlock.c - deadlock_check, dl_waitsfor, dl_report */
+
+#include <xinu.h>
+
+/* A blocked process waits for at most one other process, so the	*/
+/*   wait-for graph has out-degree one and a cycle through a process	*/
+/*   is found by following its edges until they return to it or end.	*/
+/*   Edges are derived from state each blocking path already keeps:	*/
+/*									*/
+/*	al_lock_t	pendingLockId -> holder in locks[]		*/
+/*	pi_lock_t	pendingLock -> curr_holder			*/
+/*	semaphore	PR_WAIT, prsem -> sholder (semmutex only)	*/
+/*	full mailbox	PR_SEND, prwaitfor -> recipient			*/
+/*	join		PR_JOIN, prwaitfor -> process joined		*/
+/*									*/
+/*   A process in receive() waits for any sender, and lock_t and	*/
+/*   counting semaphores record no holder, so those add no edge.	*/
+/*   Only blocking paths call deadlock_check, with interrupts disabled	*/
+/*   once the wait is recorded, so an acquisition that does not wait	*/
+/*   never walks the graph.						*/
+
+/* Formats for a deadlock report, indexed by cycle length, so the whole	*/
+/*   line goes to the log as one entry					*/
+
+local	char	*deadlock_fmt[KLOGNARG + 1] = {
+	"deadlock_detected=\n",
+	"deadlock_detected=P%d\n",
+	"deadlock_detected=P%d-P%d\n",
+	"deadlock_detected=P%d-P%d-P%d\n",
+	"deadlock_detected=P%d-P%d-P%d-P%d\n",
+	"deadlock_detected=P%d-P%d-P%d-P%d-P%d\n",
+	"deadlock_detected=P%d-P%d-P%d-P%d-P%d-P%d\n",
+	"deadlock_detected=P%d-P%d-P%d-P%d-P%d-P%d-P%d\n",
+	"deadlock_detected=P%d-P%d-P%d-P%d-P%d-P%d-P%d-P%d\n"
+};
+
+/*------------------------------------------------------------------------
+ *  dl_waitsfor  -  Return the process that pid is waiting for, or -1
+ *		      if it is not blocked on anything with an owner
+ *------------------------------------------------------------------------
+ */
+local	pid32	dl_waitsfor(
+	  pid32		pid		/* Process to follow		*/
+	)
+{
+	struct	procent	*prptr;		/* Ptr to process's table entry	*/
+	struct	sentry	*semptr;	/* Ptr to semaphore waited on	*/
+
+	if (isbadpid(pid)) {
+		return -1;
+	}
+	prptr = &proctab[pid];
+
+	/* Lock waits are recorded before the process parks */
+
+	if (prptr->pendingLockId >= 0) {
+		return (pid32)locks[prptr->pendingLockId];
+	}
+	if (prptr->pendingLock != NULL) {
+		return prptr->pendingLock->curr_holder;
+	}
+
+	switch (prptr->prstate) {
+	case PR_WAIT:
+		if (prptr->l_flag || isbadsem(prptr->prsem)) {
+			return -1;	/* Parked on a lock_t		*/
+		}
+		semptr = &semtab[prptr->prsem];
+		if ((semptr->sstate != S_USED) || !semptr->smutex) {
+			return -1;
+		}
+		return semptr->sholder;
+
+	case PR_SEND:
+	case PR_JOIN:
+		return prptr->prwaitfor;
+	}
+	return -1;
+}
+
+/*------------------------------------------------------------------------
+ *  dl_report  -  Log the n processes on the cycle through pid in
+ *		    ascending order of ID
+ *------------------------------------------------------------------------
+ */
+local	void	dl_report(
+	  pid32		pid,		/* Process on the cycle		*/
+	  int32		n		/* Length of the cycle		*/
+	)
+{
+	int32	ids[KLOGNARG];		/* IDs for a one-line report	*/
+	pid32	p, low, last;
+	int32	i, j;
+
+	/* Select the next larger ID on each pass; cycles are short	*/
+	/*   and this runs only when one has formed			*/
+
+	for (i = 0; i < KLOGNARG; i++) {
+		ids[i] = 0;		/* Passed, though not printed	*/
+	}
+	if (n > KLOGNARG) {
+		klog("deadlock_detected=");
+	}
+	last = -1;
+	for (i = 0; i < n; i++) {
+		low = NPROC;
+		for (j = 0, p = pid; j < n; j++, p = dl_waitsfor(p)) {
+			if ((p > last) && (p < low)) {
+				low = p;
+			}
+		}
+		last = low;
+		if (n <= KLOGNARG) {
+			ids[i] = low;
+		} else {
+			klog((i == 0) ? "P%d" : "-P%d", low);
+		}
+	}
+	if (n <= KLOGNARG) {
+		klog(deadlock_fmt[n], ids[0], ids[1], ids[2], ids[3], ids[4],
+			ids[5], ids[6], ids[7]);
+	} else {
+		klog("\n");
+	}
+}
+
+/*------------------------------------------------------------------------
+ *  deadlock_check  -  Called by a process about to block once its wait
+ *			 is recorded; report a cycle of waits through it
+ *			 and return TRUE if one has formed
+ *------------------------------------------------------------------------
+ */
+bool8	deadlock_check(
+	  pid32		pid		/* Process about to block	*/
+	)
+{
+	pid32	p;			/* Walks the chain of waits	*/
+	int32	n;			/* Processes passed so far	*/
+
+	/* A chain that does not return to pid may run into an older	*/
+	/*   cycle, which was reported when it formed; no simple path	*/
+	/*   is longer than the number of live processes		*/
+
+	p = dl_waitsfor(pid);
+	for (n = 1; (p >= 0) && (n <= prcount); n++) {
+		if (p == pid) {
+			dl_report(pid, n);
+			return TRUE;
+		}
+		p = dl_waitsfor(p);
+	}
+	return FALSE;
+}
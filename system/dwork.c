@@ -0,0 +1,142 @@
+/* dwork.c - dwork, dwstart, dwrelease, dworkd */
+
+#include <xinu.h>
+
+local	struct	dwent	dwring[DWLEN];
+local	uint32	dwhead = 0;		/* Items queued (producer only)	*/
+local	uint32	dwtail = 0;		/* Items taken (consumer only)	*/
+local	bool8	dwidle = FALSE;		/* dworkd is suspended, empty	*/
+local	pid32	dwpid = -1;		/* Deferred-work process	*/
+uint32	dwdropped = 0;
+
+local	process	dworkd(void);
+
+/*------------------------------------------------------------------------
+ *  dwork  -  Queue func(arg) to run in the deferred-work process;
+ *	      returns SYSERR if that process is not running or the ring
+ *	      is full, and the caller must do the work itself.  Called
+ *	      with interrupts disabled; a handler should defer
+ *	      rescheduling around it, as clkhandler does, so the process
+ *	      runs once the handler has finished rather than inside it
+ *------------------------------------------------------------------------
+ */
+syscall	dwork(
+	  void		(*func)(uint32),/* Function to call		*/
+	  uint32	arg		/* Its argument			*/
+	)
+{
+	struct	dwent	*dwptr;		/* Slot being filled		*/
+
+	if (isbadpid(dwpid)) {
+		return SYSERR;
+	}
+	if (dwhead - dwtail >= DWLEN) {
+		dwdropped++;
+		return SYSERR;
+	}
+	dwptr = &dwring[dwhead & (DWLEN - 1)];
+	dwptr->dwfunc = func;
+	dwptr->dwarg = arg;
+
+	/* Publish the item only after its contents are in place */
+
+	asm volatile ("" : : : "memory");
+	dwhead++;
+
+	if (dwidle) {
+		dwidle = FALSE;
+		ready(dwpid);
+	}
+	return OK;
+}
+
+/*------------------------------------------------------------------------
+ *  dwstart  -  Start the deferred-work process
+ *------------------------------------------------------------------------
+ */
+syscall	dwstart(void)
+{
+	intmask	mask;			/* Saved interrupt mask		*/
+	pid32	pid;
+
+	mask = disable();
+	if (dwpid != -1) {
+		restore(mask);
+		return OK;
+	}
+	pid = create(dworkd, DWSTK, DWPRIO, "dworkd", 0);
+	if (pid == SYSERR) {
+		restore(mask);
+		return SYSERR;
+	}
+	dwpid = pid;
+	resume(pid);
+	restore(mask);
+	return OK;
+}
+
+/*------------------------------------------------------------------------
+ *  dwrelease  -  Forget the deferred-work process as it is killed, so
+ *		  dwork neither readies a later process given its ID nor
+ *		  queues work nobody will run; items still queued are
+ *		  run here (interrupts disabled)
+ *------------------------------------------------------------------------
+ */
+void	dwrelease(
+	  pid32		pid		/* ID of process being killed	*/
+	)
+{
+	struct	dwent	*dwptr;		/* Item being taken		*/
+
+	if (pid != dwpid) {
+		return;
+	}
+	dwpid = -1;
+	dwidle = FALSE;
+
+	resched_cntl(DEFER_START);
+	while (dwtail != dwhead) {
+		dwptr = &dwring[dwtail & (DWLEN - 1)];
+		dwtail++;
+		(*dwptr->dwfunc)(dwptr->dwarg);
+	}
+	resched_cntl(DEFER_STOP);
+}
+
+/*------------------------------------------------------------------------
+ *  dworkd  -  Run queued items in order with interrupts enabled, and
+ *	       suspend once the ring is empty
+ *------------------------------------------------------------------------
+ */
+local	process	dworkd(void)
+{
+	intmask	mask;			/* Saved interrupt mask		*/
+	struct	dwent	*dwptr;		/* Item being taken		*/
+	void	(*func)(uint32);	/* Its function			*/
+	uint32	arg;			/*   and argument		*/
+
+	while (TRUE) {
+		while (dwtail != dwhead) {
+			asm volatile ("" : : : "memory");
+			dwptr = &dwring[dwtail & (DWLEN - 1)];
+			func = dwptr->dwfunc;
+			arg = dwptr->dwarg;
+			asm volatile ("" : : : "memory");
+			dwtail++;	/* Slot may now be reused	*/
+
+			(*func)(arg);	/* Interrupts stay enabled	*/
+		}
+
+		/* Check for an item queued since the last one was taken	*/
+		/*   with interrupts off, so dwork cannot miss dwidle		*/
+
+		mask = disable();
+		if (dwtail == dwhead) {
+			dwidle = TRUE;
+			proctab[currpid].prstate = PR_SUSP;
+			resched();
+		}
+		restore(mask);
+	}
+	return OK;
+}
@@ -0,0 +1,406 @@
+/* fiber.c - fib_create, fib_yield, fib_exit, fib_self, fib_run,	*/
+/*	     fib_reclaim, fib_mutex_init, fib_mutex_lock,		*/
+/*	     fib_mutex_unlock						*/
+
+#include <xinu.h>
+
+struct	fibent	fibtab[NFIBER];		/* Fiber table			*/
+
+struct	fibsched {			/* Fiber state of one process	*/
+	bool8	fsinit;			/* Has the entry been set up?	*/
+	int32	fscur;			/* Running fiber, or FIBMAIN	*/
+	int32	fshead;			/* First ready fiber		*/
+	int32	fstail;			/* Last ready fiber		*/
+	int32	fsnlive;		/* Fibers that have not exited	*/
+	int32	fsdead;			/* Exited fiber whose stack	*/
+					/*   must still be freed	*/
+	int32	fsall;			/* First fiber the process owns	*/
+	char	*fsmainsp;		/* Saved SP of fib_run		*/
+};
+
+local	struct	fibsched fibsched[NPROC];
+local	int32	fibfree = EMPTY;	/* First free fiber table entry	*/
+local	bool8	fibinit = FALSE;	/* Has the free list been built?*/
+
+/*------------------------------------------------------------------------
+ *  fibget  -  Take an entry off the free list and link it into the
+ *		 owner's list, or return SYSERR if the table is full
+ *		 (interrupts disabled)
+ *------------------------------------------------------------------------
+ */
+local	int32	fibget(
+	  struct fibsched *fs		/* Fiber state of the owner	*/
+	)
+{
+	int32	f;
+
+	if (!fibinit) {			/* Chain every entry, once	*/
+		for (f = NFIBER - 1; f >= 0; f--) {
+			fibtab[f].fbnext = fibfree;
+			fibfree = f;
+		}
+		fibinit = TRUE;
+	}
+	f = fibfree;
+	if (f == EMPTY) {
+		return SYSERR;
+	}
+	fibfree = fibtab[f].fbnext;
+
+	fibtab[f].fbpprev = EMPTY;
+	fibtab[f].fbpnext = fs->fsall;
+	if (fs->fsall != EMPTY) {
+		fibtab[fs->fsall].fbpprev = f;
+	}
+	fs->fsall = f;
+	return f;
+}
+
+/*------------------------------------------------------------------------
+ *  fibput  -  Free a fiber's stack, unlink it from the owner's list,
+ *		 and return its entry to the free list (interrupts
+ *		 disabled)
+ *------------------------------------------------------------------------
+ */
+local	void	fibput(
+	  struct fibsched *fs,		/* Fiber state of the owner	*/
+	  int32		f		/* Fiber to free		*/
+	)
+{
+	struct	fibent	*fbptr = &fibtab[f];
+
+	stkcput(fbptr->fbstkbase, fbptr->fbstklen);
+	if (fbptr->fbpprev == EMPTY) {
+		fs->fsall = fbptr->fbpnext;
+	} else {
+		fibtab[fbptr->fbpprev].fbpnext = fbptr->fbpnext;
+	}
+	if (fbptr->fbpnext != EMPTY) {
+		fibtab[fbptr->fbpnext].fbpprev = fbptr->fbpprev;
+	}
+	fbptr->fbstate = FB_FREE;
+	fbptr->fbnext = fibfree;
+	fibfree = f;
+}
+
+/*------------------------------------------------------------------------
+ *  fibsched_of  -  Return the fiber state of the current process,
+ *		      setting it up on first use
+ *------------------------------------------------------------------------
+ */
+local	struct	fibsched *fibsched_of(void)
+{
+	struct	fibsched *fs = &fibsched[currpid];
+
+	if (!fs->fsinit) {
+		fs->fscur = FIBMAIN;
+		fs->fshead = fs->fstail = EMPTY;
+		fs->fsnlive = 0;
+		fs->fsdead = EMPTY;
+		fs->fsall = EMPTY;
+		fs->fsinit = TRUE;
+	}
+	return fs;
+}
+
+/*------------------------------------------------------------------------
+ *  fibready  -  Add a fiber to the tail of the ready list
+ *------------------------------------------------------------------------
+ */
+local	void	fibready(
+	  struct fibsched *fs,		/* Fiber state of the process	*/
+	  int32		f		/* Fiber to add			*/
+	)
+{
+	fibtab[f].fbstate = FB_READY;
+	fibtab[f].fbnext = EMPTY;
+	if (fs->fshead == EMPTY) {
+		fs->fshead = f;
+	} else {
+		fibtab[fs->fstail].fbnext = f;
+	}
+	fs->fstail = f;
+}
+
+/*------------------------------------------------------------------------
+ *  fibreap  -  Free the stack of a fiber that exited; done by whoever
+ *		  runs next, since a fiber cannot free the stack it is on
+ *------------------------------------------------------------------------
+ */
+local	void	fibreap(
+	  struct fibsched *fs		/* Fiber state of the process	*/
+	)
+{
+	intmask	mask;			/* Saved interrupt mask		*/
+
+	if (fs->fsdead == EMPTY) {
+		return;
+	}
+	mask = disable();
+	fibput(fs, fs->fsdead);
+	fs->fsdead = EMPTY;
+	restore(mask);
+}
+
+/*------------------------------------------------------------------------
+ *  fibnext  -  Switch from the running fiber to the first ready one,
+ *		  or back to fib_run if none is ready
+ *------------------------------------------------------------------------
+ */
+local	void	fibnext(
+	  struct fibsched *fs		/* Fiber state of the process	*/
+	)
+{
+	int32	cur, next;		/* Old and new fiber		*/
+	char	**oldsp;		/* Where to save the old SP	*/
+	char	*newsp;			/* SP of the new fiber		*/
+
+	cur = fs->fscur;
+	next = fs->fshead;
+	if (next == EMPTY) {
+		next = FIBMAIN;
+		newsp = fs->fsmainsp;
+	} else {
+		fs->fshead = fibtab[next].fbnext;
+		fibtab[next].fbstate = FB_CURR;
+		newsp = fibtab[next].fbsp;
+	}
+	if (next == cur) {		/* Only runnable fiber yielded	*/
+		return;
+	}
+	oldsp = (cur == FIBMAIN) ? &fs->fsmainsp : &fibtab[cur].fbsp;
+	fs->fscur = next;
+	fibswitch(oldsp, newsp);
+	fibreap(fs);
+}
+
+/*------------------------------------------------------------------------
+ *  fibstart  -  Where every fiber begins: run its function, then exit
+ *------------------------------------------------------------------------
+ */
+local	void	fibstart(void)
+{
+	struct	fibsched *fs = &fibsched[currpid];
+	struct	fibent	*fbptr = &fibtab[fs->fscur];
+
+	fibreap(fs);
+	(*fbptr->fbfunc)(fbptr->fbarg);
+	fib_exit();
+}
+
+/*------------------------------------------------------------------------
+ *  fib_create  -  Create a ready fiber in the current process that will
+ *		     run fn(arg) on a stack of ssize bytes
+ *------------------------------------------------------------------------
+ */
+int32	fib_create(
+	  void		(*fn)(void *),	/* Function for the fiber	*/
+	  void		*arg,		/* Argument passed to fn	*/
+	  uint32	ssize		/* Stack size in bytes		*/
+	)
+{
+	intmask	mask;			/* Saved interrupt mask		*/
+	struct	fibsched *fs;		/* Fiber state of the process	*/
+	struct	fibent	*fbptr;		/* Ptr to the new fiber		*/
+	uint32	*saddr;			/* Stack address		*/
+	int32	f;
+
+	if (fn == NULL) {
+		return SYSERR;
+	}
+	if (ssize < FIBMINSTK) {
+		ssize = FIBMINSTK;
+	}
+	ssize = (uint32) roundmb(ssize);
+
+	mask = disable();
+	fs = fibsched_of();
+	saddr = (uint32 *)stkcget(ssize);
+	if (saddr == (uint32 *)SYSERR) {
+		restore(mask);
+		return SYSERR;
+	}
+	f = fibget(fs);
+	if (f == SYSERR) {
+		stkcput((char *)saddr, ssize);
+		restore(mask);
+		return SYSERR;
+	}
+	fbptr = &fibtab[f];
+	fbptr->fbowner = currpid;
+	fbptr->fbstkbase = (char *)saddr;
+	fbptr->fbstklen = ssize;
+	fbptr->fbfunc = fn;
+	fbptr->fbarg = arg;
+
+	/* Build the frame fibswitch pops: four registers, then the	*/
+	/*   address it returns to					*/
+
+	*saddr = STACKMAGIC;
+	*--saddr = 0;			/* fibstart never returns	*/
+	*--saddr = (uint32)fibstart;
+	*--saddr = 0;			/* %ebp				*/
+	*--saddr = 0;			/* %ebx				*/
+	*--saddr = 0;			/* %esi				*/
+	*--saddr = 0;			/* %edi				*/
+	fbptr->fbsp = (char *)saddr;
+
+	fibready(fs, f);
+	fs->fsnlive++;
+	restore(mask);
+	return f;
+}
+
+/*------------------------------------------------------------------------
+ *  fib_yield  -  Let the other ready fibers of this process run
+ *------------------------------------------------------------------------
+ */
+syscall	fib_yield(void)
+{
+	struct	fibsched *fs = fibsched_of();
+
+	if (fs->fscur == FIBMAIN) {
+		return SYSERR;		/* fib_run is not a fiber	*/
+	}
+	fibready(fs, fs->fscur);
+	fibnext(fs);
+	return OK;
+}
+
+/*------------------------------------------------------------------------
+ *  fib_exit  -  End the running fiber (also reached when its function
+ *		   returns)
+ *------------------------------------------------------------------------
+ */
+void	fib_exit(void)
+{
+	struct	fibsched *fs = fibsched_of();
+
+	if (fs->fscur == FIBMAIN) {
+		return;
+	}
+	fibtab[fs->fscur].fbstate = FB_DEAD;
+	fs->fsdead = fs->fscur;
+	fs->fsnlive--;
+	fibnext(fs);			/* Does not return		*/
+}
+
+/*------------------------------------------------------------------------
+ *  fib_self  -  Return the ID of the running fiber, or FIBMAIN
+ *------------------------------------------------------------------------
+ */
+int32	fib_self(void)
+{
+	return fibsched_of()->fscur;
+}
+
+/*------------------------------------------------------------------------
+ *  fib_run  -  Run the fibers of the current process until all have
+ *		  exited; SYSERR if the remaining ones all wait on mutexes
+ *------------------------------------------------------------------------
+ */
+syscall	fib_run(void)
+{
+	struct	fibsched *fs = fibsched_of();
+
+	if (fs->fscur != FIBMAIN) {
+		return SYSERR;
+	}
+	while (fs->fsnlive > 0) {
+		if (fs->fshead == EMPTY) {
+			return SYSERR;
+		}
+		fibnext(fs);
+	}
+	return OK;
+}
+
+/*------------------------------------------------------------------------
+ *  fib_reclaim  -  Free the fibers of a process that is being killed
+ *		      (assumes interrupts are disabled)
+ *------------------------------------------------------------------------
+ */
+void	fib_reclaim(
+	  pid32		pid		/* ID of process being killed	*/
+	)
+{
+	struct	fibsched *fs = &fibsched[pid];
+
+	if (!fs->fsinit) {
+		return;
+	}
+	while (fs->fsall != EMPTY) {	/* Live, waiting, and dead ones	*/
+		fibput(fs, fs->fsall);
+	}
+	fs->fsinit = FALSE;
+}
+
+/*------------------------------------------------------------------------
+ *  fib_mutex_init  -  Initialize a mutex shared by fibers of a process
+ *------------------------------------------------------------------------
+ */
+void	fib_mutex_init(
+	  struct fibmutex *m		/* Mutex to initialize		*/
+	)
+{
+	m->fmowner = m->fmhead = m->fmtail = EMPTY;
+}
+
+/*------------------------------------------------------------------------
+ *  fib_mutex_lock  -  Acquire a fiber mutex; a fiber that must wait is
+ *			 switched out and the process keeps running its
+ *			 other fibers
+ *------------------------------------------------------------------------
+ */
+syscall	fib_mutex_lock(
+	  struct fibmutex *m		/* Mutex to acquire		*/
+	)
+{
+	struct	fibsched *fs = fibsched_of();
+	int32	cur = fs->fscur;
+
+	if (m->fmowner == EMPTY) {
+		m->fmowner = cur;
+		return OK;
+	}
+	if ((cur == FIBMAIN) || (m->fmowner == cur)) {
+		return SYSERR;		/* fib_run cannot wait, and a	*/
+	}				/*   fiber cannot wait on itself*/
+
+	fibtab[cur].fbstate = FB_WAIT;
+	fibtab[cur].fbnext = EMPTY;
+	if (m->fmhead == EMPTY) {
+		m->fmhead = cur;
+	} else {
+		fibtab[m->fmtail].fbnext = cur;
+	}
+	m->fmtail = cur;
+	fibnext(fs);			/* Unlock hands us the mutex	*/
+	return OK;
+}
+
+/*------------------------------------------------------------------------
+ *  fib_mutex_unlock  -  Release a fiber mutex, handing it to the first
+ *			   waiting fiber
+ *------------------------------------------------------------------------
+ */
+syscall	fib_mutex_unlock(
+	  struct fibmutex *m		/* Mutex to release		*/
+	)
+{
+	struct	fibsched *fs = fibsched_of();
+	int32	next;			/* Fiber that gets the mutex	*/
+
+	if (m->fmowner != fs->fscur) {
+		return SYSERR;
+	}
+	next = m->fmhead;
+	if (next == EMPTY) {
+		m->fmowner = EMPTY;
+		return OK;
+	}
+	m->fmhead = fibtab[next].fbnext;
+	m->fmowner = next;
+	fibready(fs, next);
+	return OK;
+}
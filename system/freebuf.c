@@ -0,0 +1,51 @@
+/* freebuf.c - freebuf */
+
+#include <xinu.h>
+
+/*------------------------------------------------------------------------
+ *  freebuf  -  Free a buffer that was allocated from a pool by getbuf
+ *------------------------------------------------------------------------
+ */
+syscall	freebuf(
+          char      *bufaddr		/* Address of buffer to return	*/
+	)
+{
+	intmask	mask;			/* Saved interrupt mask		*/
+	struct	bpentry	*bpptr;		/* Pointer to entry in buftab	*/
+	struct	bphdr	*hdr;		/* Header of the buffer		*/
+	bpid32	poolid;			/* ID of buffer's pool		*/
+
+	mask = disable();
+
+	/* Extract pool ID from the header that precedes the buffer	*/
+
+	hdr = bufhdr(bufaddr);
+	poolid = hdr->bhpool;
+	if (poolid < 0  ||  poolid >= nbpools) {
+		restore(mask);
+		return SYSERR;
+	}
+
+	/* A buffer still in an inbox belongs to a process that has	*/
+	/*   not received it yet					*/
+
+	if (hdr->bhqueued) {
+		restore(mask);
+		return SYSERR;
+	}
+	bpptr = &buftab[poolid];
+
+	/* Any process may free a buffer it was handed, as network	*/
+	/*   consumers do with packets netin took; clearing the owner	*/
+	/*   makes a stale sendbuf of the freed buffer fail		*/
+
+	hdr->bhowner = -1;
+
+	/* Insert buffer into list and signal semaphore */
+
+	((struct bpentry *)hdr)->bpnext = bpptr->bpnext;
+	bpptr->bpnext = (struct bpentry *)hdr;
+	signal(bpptr->bpsem);
+	restore(mask);
+	return OK;
+}
@@ -0,0 +1,49 @@
+/* getbuf.c - getbuf */
+
+#include <xinu.h>
+
+/*------------------------------------------------------------------------
+ *  getbuf  -  Get a buffer from a preestablished buffer pool; the
+ *		 calling process becomes its owner
+ *------------------------------------------------------------------------
+ */
+char    *getbuf(
+          bpid32        poolid          /* Index of pool in buftab       */
+        )
+{
+	intmask	mask;			/* Saved interrupt mask		*/
+	struct	bpentry	*bpptr;		/* Pointer to entry in buftab	*/
+	struct	bphdr	*hdr;		/* Header of allocated buffer	*/
+
+	mask = disable();
+
+	/* Check arguments */
+
+	if ( (poolid < 0  ||  poolid >= nbpools) ) {
+		restore(mask);
+		return (char *)SYSERR;
+	}
+	bpptr = &buftab[poolid];
+
+	/* Wait for pool to have > 0 buffers and allocate a buffer */
+
+	if (wait(bpptr->bpsem) == SYSERR) {
+		restore(mask);
+		return (char *)SYSERR;
+	}
+	hdr = (struct bphdr *)bpptr->bpnext;
+
+	/* Unlink buffer from pool */
+
+	bpptr->bpnext = bpptr->bpnext->bpnext;
+
+	/* Record pool ID and owner in the header; return the address	*/
+	/*   that follows it						*/
+
+	hdr->bhpool = poolid;
+	hdr->bhowner = currpid;
+	hdr->bhnext = NULL;
+	hdr->bhqueued = FALSE;
+	restore(mask);
+	return (char *)(hdr + 1);
+}
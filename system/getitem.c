@@ -0,0 +1,64 @@
+/* getitem.c - getfirst, getlast, getitem */
+
+#include <xinu.h>
+
+/*------------------------------------------------------------------------
+ *  getfirst  -  Remove a process from the front of a queue
+ *------------------------------------------------------------------------
+ */
+pid32	getfirst(
+	  qid16		q		/* ID of queue from which to	*/
+	)				/* Remove a process (assumed	*/
+					/*   valid with no check)	*/
+{
+	pid32	head;
+
+	if (isempty(q)) {
+		return EMPTY;
+	}
+
+	head = queuehead(q);
+	return getitem(queuetab[head].qnext);
+}
+
+/*------------------------------------------------------------------------
+ *  getlast  -  Remove a process from end of queue
+ *------------------------------------------------------------------------
+ */
+pid32	getlast(
+	  qid16		q		/* ID of queue from which to	*/
+	)				/* Remove a process (assumed	*/
+					/*   valid with no check)	*/
+{
+	pid32 tail;
+
+	if (isempty(q)) {
+		return EMPTY;
+	}
+
+	tail = queuetail(q);
+	return getitem(queuetab[tail].qprev);
+}
+
+/*------------------------------------------------------------------------
+ *  getitem  -  Remove a process from an arbitrary point in a queue
+ *------------------------------------------------------------------------
+ */
+pid32	getitem(
+	  pid32		pid		/* ID of process to remove	*/
+	)
+{
+	pid32	prev, next;
+
+	/* Ready processes live on the per-priority ready lists */
+
+	if (proctab[pid].prstate == PR_READY) {
+		return rq_remove(pid);
+	}
+
+	next = queuetab[pid].qnext;	/* Following node in list	*/
+	prev = queuetab[pid].qprev;	/* Previous node in list	*/
+	queuetab[prev].qnext = next;
+	queuetab[next].qprev = prev;
+	return pid;
+}
@@ -0,0 +1,38 @@
+/* getprocstats.c - getprocstats */
+
+#include <xinu.h>
+
+/*------------------------------------------------------------------------
+ *  getprocstats  -  Return CPU time, time parked on locks, and context
+ *		       switch counts for a process, all in TSC cycles
+ *------------------------------------------------------------------------
+ */
+syscall	getprocstats(
+	  pid32		pid,		/* Process to report on		*/
+	  struct procstats *stats	/* Where to store the counters	*/
+	)
+{
+	intmask	mask;			/* Saved interrupt mask		*/
+	struct	procent	*prptr;		/* Ptr to process's table entry	*/
+	uint64	now;			/* Current TSC			*/
+
+	mask = disable();
+	if (isbadpid(pid) || (stats == NULL)) {
+		restore(mask);
+		return SYSERR;
+	}
+	prptr = &proctab[pid];
+	now = getticks();
+
+	stats->ps_cputime = prptr->cputime;
+	if (pid == currpid) {		/* Include the current slice	*/
+		stats->ps_cputime += now - prptr->swintime;
+	}
+	stats->ps_parktime = prptr->parktime;
+	stats->ps_lifetime = now - prptr->starttime;
+	stats->ps_nctxsw = prptr->num_ctxsw;
+	stats->ps_nvolsw = prptr->num_volsw;
+	stats->ps_ninvsw = prptr->num_invsw;
+	restore(mask);
+	return OK;
+}
@@ -0,0 +1,140 @@
+/* irqtrack.c - irqtrack_disable, irqtrack_restore, irqtrack_get,	*/
+/*		irqtrack_reset						*/
+
+#include <xinu.h>
+
+#ifdef	IRQTRACK
+
+#undef	disable				/* This file uses the real ones	*/
+#undef	restore
+
+local	struct	irqtsite irqtsitetab[IRQTNSITE];
+local	int32	nirqtsite = 0;		/* Entries used in irqtsitetab	*/
+
+local	uint64	itstart;		/* When the open window began	*/
+local	char	*itfile;		/*   and where			*/
+local	int32	itline;
+
+/*------------------------------------------------------------------------
+ *  itcharge  -  Charge a window to its site, displacing the site with
+ *		   the shortest longest window once the table is full
+ *		   (interrupts disabled)
+ *------------------------------------------------------------------------
+ */
+local	void	itcharge(
+	  char		*file,		/* Site of the disable()	*/
+	  int32		line,
+	  uint64	len		/* Cycles interrupts were off	*/
+	)
+{
+	struct	irqtsite *its;		/* Entry for the site		*/
+	int32	i;
+
+	its = NULL;
+	for (i = 0; i < nirqtsite; i++) {
+		if ((irqtsitetab[i].itline == line)
+		    && (irqtsitetab[i].itfile == file)) {
+			its = &irqtsitetab[i];
+			break;
+		}
+	}
+	if (its == NULL) {
+		if (nirqtsite < IRQTNSITE) {
+			its = &irqtsitetab[nirqtsite++];
+		} else {
+			its = &irqtsitetab[0];
+			for (i = 1; i < IRQTNSITE; i++) {
+				if (irqtsitetab[i].itmax < its->itmax) {
+					its = &irqtsitetab[i];
+				}
+			}
+			if (len <= its->itmax) {
+				return;
+			}
+		}
+		its->itfile = file;
+		its->itline = line;
+		its->itcount = 0;
+		its->ittotal = 0;
+		its->itmax = 0;
+	}
+	its->itcount++;
+	its->ittotal += len;
+	if (len > its->itmax) {
+		its->itmax = len;
+	}
+}
+
+/*------------------------------------------------------------------------
+ *  irqtrack_disable  -  disable(), opening a window if interrupts were
+ *			   on
+ *------------------------------------------------------------------------
+ */
+intmask	irqtrack_disable(
+	  char		*file,		/* Site of the call		*/
+	  int32		line
+	)
+{
+	intmask	mask;			/* Saved interrupt mask		*/
+
+	mask = disable();
+	if (mask & IRQTIF) {
+		itstart = getticks();
+		itfile = file;
+		itline = line;
+	}
+	return mask;
+}
+
+/*------------------------------------------------------------------------
+ *  irqtrack_restore  -  restore(), closing the window if it turns
+ *			   interrupts back on
+ *------------------------------------------------------------------------
+ */
+void	irqtrack_restore(
+	  intmask	mask		/* Value returned by disable	*/
+	)
+{
+	if ((mask & IRQTIF) && (itfile != NULL)) {
+		itcharge(itfile, itline, getticks() - itstart);
+		itfile = NULL;
+	}
+	restore(mask);
+}
+
+/*------------------------------------------------------------------------
+ *  irqtrack_get  -  Copy the index'th site kept, or return SYSERR once
+ *		       index runs past them
+ *------------------------------------------------------------------------
+ */
+syscall	irqtrack_get(
+	  int32		index,		/* Position in the site table	*/
+	  struct irqtsite *its		/* Where to copy the entry	*/
+	)
+{
+	intmask	mask;			/* Saved interrupt mask		*/
+
+	mask = disable();
+	if ((index < 0) || (index >= nirqtsite) || (its == NULL)) {
+		restore(mask);
+		return SYSERR;
+	}
+	memcpy(its, &irqtsitetab[index], sizeof(struct irqtsite));
+	restore(mask);
+	return OK;
+}
+
+/*------------------------------------------------------------------------
+ *  irqtrack_reset  -  Forget every site; the open window still counts
+ *------------------------------------------------------------------------
+ */
+void	irqtrack_reset(void)
+{
+	intmask	mask;			/* Saved interrupt mask		*/
+
+	mask = disable();
+	nirqtsite = 0;
+	restore(mask);
+}
+
+#endif
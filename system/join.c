@@ -0,0 +1,70 @@
+/* join.c - join, joinrelease */
+
+#include <xinu.h>
+
+local	qid16	joinq = 0;		/* Every process in PR_JOIN	*/
+
+/*------------------------------------------------------------------------
+ *  join  -  Block the current process until process pid has exited
+ *------------------------------------------------------------------------
+ */
+syscall	join(
+	  pid32		pid		/* ID of process to wait for	*/
+	)
+{
+	intmask	mask;			/* Saved interrupt mask		*/
+	struct	procent *prptr;		/* Ptr to process's table entry	*/
+	qid16	q;
+
+	mask = disable();
+	if (isbadpid(pid) || (pid == NULLPROC) || (pid == currpid)) {
+		restore(mask);
+		return SYSERR;
+	}
+
+	/* One queue holds all joiners; kill looks through it only when	*/
+	/*   someone is joining, so it stays short			*/
+
+	if (joinq == 0) {
+		q = newqueue();
+		if (q == (qid16) SYSERR) {
+			restore(mask);
+			return SYSERR;
+		}
+		joinq = q;
+	}
+
+	prptr = &proctab[currpid];
+	prptr->prstate = PR_JOIN;
+	prptr->prwaitfor = pid;
+	enqueue(currpid, joinq);
+	deadlock_check(currpid);
+	resched();
+	restore(mask);
+	return OK;
+}
+
+/*------------------------------------------------------------------------
+ *  joinrelease  -  Make ready every process joining pid, which is being
+ *		      killed (interrupts disabled)
+ *------------------------------------------------------------------------
+ */
+void	joinrelease(
+	  pid32		pid		/* ID of exiting process	*/
+	)
+{
+	qid16	curr, next;		/* Walk the join queue		*/
+
+	if ((joinq == 0) || isempty(joinq)) {
+		return;
+	}
+	resched_cntl(DEFER_START);
+	for (curr = firstid(joinq); curr < NPROC; curr = next) {
+		next = queuetab[curr].qnext;
+		if (proctab[curr].prwaitfor == pid) {
+			getitem(curr);
+			ready(curr);
+		}
+	}
+	resched_cntl(DEFER_STOP);
+}
@@ -0,0 +1,78 @@
+/* kill.c - kill */
+
+#include <xinu.h>
+
+/*------------------------------------------------------------------------
+ *  kill  -  Kill a process and remove it from the system
+ *------------------------------------------------------------------------
+ */
+syscall	kill(
+	  pid32		pid		/* ID of process to kill	*/
+	)
+{
+	intmask	mask;			/* Saved interrupt mask		*/
+	struct	procent *prptr;		/* Ptr to process's table entry	*/
+	pid32	parent;			/* Process told of the exit	*/
+	int32	i;			/* Index into descriptors	*/
+
+	mask = disable();
+	if (isbadpid(pid) || (pid == NULLPROC)
+	    || ((prptr = &proctab[pid])->prstate) == PR_FREE) {
+		restore(mask);
+		return SYSERR;
+	}
+
+	if (--prcount <= 1) {		/* Last user process completes	*/
+		xdone();
+	}
+
+	/* Tell the parent without waiting: one that never receives	*/
+	/*   and has a full mailbox simply misses the notice		*/
+
+	parent = prptr->prparent;
+	if (!isbadpid(parent) && (proctab[parent].prmbcount < MBOXLEN)) {
+		mbdeliver(parent, pid);
+	}
+	mbrelease(pid);			/* Fail senders waiting on us	*/
+	joinrelease(pid);		/* Start processes joining us	*/
+	semrelease(pid);		/* Forget it as a mutex holder	*/
+	dwrelease(pid);			/* Stop deferring work to it	*/
+	bufreclaim(pid);		/* Free buffers not yet received*/
+	for (i=0; i<3; i++) {
+		close(prptr->prdesc[i]);
+	}
+	fib_reclaim(pid);		/* Free any fibers it had	*/
+	stkrecord(pid);			/* Fold peak use into the stats	*/
+	stkcput(prptr->prstkbase, prptr->prstklen);	/* Keep for reuse	*/
+	freepid(pid);			/* ID may be reused from now on	*/
+
+	switch (prptr->prstate) {
+	case PR_CURR:
+		prptr->prstate = PR_FREE;	/* Suicide */
+		resched();
+
+	case PR_SLEEP:
+	case PR_RECTIM:
+		unsleep(pid);
+		prptr->prstate = PR_FREE;
+		break;
+
+	case PR_WAIT:
+		if (!prptr->l_flag) {	/* Lock waiters have no prsem	*/
+			semtab[prptr->prsem].scount++;
+		}
+		/* Fall through */
+
+	case PR_SEND:
+	case PR_JOIN:
+	case PR_READY:
+		getitem(pid);		/* Remove from queue */
+		/* Fall through */
+
+	default:
+		prptr->prstate = PR_FREE;
+	}
+
+	restore(mask);
+	return OK;
+}
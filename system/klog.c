@@ -0,0 +1,170 @@
+/* klog.c - klog, klognargs, klogflush, klogstart, klogd */
+
+#include <xinu.h>
+#include <stdarg.h>
+
+local	struct	klogent	klogbuf[KLOGLEN];
+local	uint32	kloghead = 0;		/* Tickets handed to writers	*/
+local	uint32	klogtail = 0;		/* Next ticket to print		*/
+local	uint32	klogbusy = 0;		/* A flush is in progress	*/
+local	pid32	klogpid = -1;		/* Drain process, once started	*/
+local	uint32	klogreported = 0;	/* Drops already announced	*/
+uint32	klogdropped = 0;
+
+local	int32	klognargs(char *);
+local	process	klogd(void);
+
+/*------------------------------------------------------------------------
+ *  klog  -  Record a message for the drain process to print; never
+ *	     blocks or disables interrupts, so it may be used on lock
+ *	     paths and in interrupt handlers
+ *------------------------------------------------------------------------
+ */
+syscall	klog(
+	  char		*fmt,		/* kprintf format (a constant)	*/
+	  ...				/* Up to KLOGNARG 32-bit args	*/
+	)
+{
+	va_list	ap;			/* Walks the arguments		*/
+	struct	klogent	*kptr;		/* Entry being filled		*/
+	uint32	ticket;			/* Slot reserved for us		*/
+	int32	n;			/* Arguments the format uses	*/
+	int32	i;
+
+	/* Reserve a slot with compare-and-swap so that an interrupt	*/
+	/*   that logs between our read and our update cannot share it	*/
+
+	do {
+		ticket = kloghead;
+		if (ticket - klogtail >= KLOGLEN) {
+			__sync_fetch_and_add(&klogdropped, 1);
+			return SYSERR;
+		}
+	} while (__sync_val_compare_and_swap(&kloghead, ticket, ticket + 1)
+			!= ticket);
+
+	kptr = &klogbuf[ticket & (KLOGLEN - 1)];
+	kptr->klfmt = fmt;
+	n = klognargs(fmt);
+	va_start(ap, fmt);
+	for (i = 0; i < n; i++) {
+		kptr->klarg[i] = va_arg(ap, uint32);
+	}
+	va_end(ap);
+	for ( ; i < KLOGNARG; i++) {
+		kptr->klarg[i] = 0;
+	}
+
+	/* Publish the entry only after its contents are in place */
+
+	asm volatile ("" : : : "memory");
+	kptr->klseq = ticket + 1;
+	return OK;
+}
+
+/*------------------------------------------------------------------------
+ *  klognargs  -  Count the arguments a kprintf format consumes, so klog
+ *		  reads only those the caller passed (at most KLOGNARG)
+ *------------------------------------------------------------------------
+ */
+local	int32	klognargs(
+	  char		*fmt		/* kprintf format		*/
+	)
+{
+	int32	n = 0;			/* Arguments found so far	*/
+
+	while (*fmt != NULLCH) {
+		if (*fmt++ != '%') {
+			continue;
+		}
+		if (*fmt == '%') {	/* A literal percent sign	*/
+			fmt++;
+			continue;
+		}
+
+		/* Skip flags, width, precision, and length; a '*' width	*/
+		/*   or precision takes an argument of its own		*/
+
+		while ((*fmt == '-') || (*fmt == '+') || (*fmt == ' ')
+		    || (*fmt == '#') || (*fmt == '.') || (*fmt == '*')
+		    || (*fmt == 'l') || (*fmt == 'h')
+		    || ((*fmt >= '0') && (*fmt <= '9'))) {
+			if (*fmt++ == '*') {
+				n++;
+			}
+		}
+		if (*fmt != NULLCH) {
+			fmt++;		/* The conversion character	*/
+			n++;
+		}
+	}
+	return (n < KLOGNARG) ? n : KLOGNARG;
+}
+
+/*------------------------------------------------------------------------
+ *  klogflush  -  Print every complete entry in the ring, in order
+ *------------------------------------------------------------------------
+ */
+void	klogflush(void)
+{
+	struct	klogent	*kptr;		/* Entry being printed		*/
+	uint32	*a;			/* Its arguments		*/
+
+	if (test_and_set(&klogbusy, 1)) {
+		return;			/* Another process is flushing	*/
+	}
+	while (klogtail != kloghead) {
+		kptr = &klogbuf[klogtail & (KLOGLEN - 1)];
+		if (kptr->klseq != klogtail + 1) {
+			break;		/* Writer has not finished	*/
+		}
+		a = kptr->klarg;
+		kprintf(kptr->klfmt, a[0], a[1], a[2], a[3], a[4], a[5],
+			a[6], a[7]);
+		klogtail++;
+	}
+	if (klogdropped != klogreported) {
+		kprintf("klog: %u messages dropped\n",
+			klogdropped - klogreported);
+		klogreported = klogdropped;
+	}
+	klogbusy = 0;
+}
+
+/*------------------------------------------------------------------------
+ *  klogstart  -  Start the process that drains the log
+ *------------------------------------------------------------------------
+ */
+syscall	klogstart(void)
+{
+	intmask	mask;			/* Saved interrupt mask		*/
+	pid32	pid;
+
+	mask = disable();
+	if (klogpid != -1) {
+		restore(mask);
+		return OK;
+	}
+	pid = create(klogd, KLOGSTK, KLOGPRIO, "klogd", 0);
+	if (pid == SYSERR) {
+		restore(mask);
+		return SYSERR;
+	}
+	klogpid = pid;
+	resume(pid);
+	restore(mask);
+	return OK;
+}
+
+/*------------------------------------------------------------------------
+ *  klogd  -  Drain the log every KLOGPERIOD milliseconds
+ *------------------------------------------------------------------------
+ */
+local	process	klogd(void)
+{
+	while (TRUE) {
+		klogflush();
+		sleepms(KLOGPERIOD);
+	}
+	return OK;
+}
@@ -20,6 +20,7 @@ syscall initlock(lock_t *l)
     l->flag = 0;  // Ensure the lock starts as unlocked
     l->guard = 0;
     l->queue = newqueue();
+    LS_REGISTER(l, LS_LOCK);
     return OK;
 }
 
@@ -27,19 +28,30 @@ syscall lock(lock_t *l)
 {
     while(test_and_set(&l->guard, 1)) 
     {
+        LS_SPIN(l);
+        LS_BACKOFF(l);
         sleepms(QUANTUM);
     }
     if (l->flag == 0) 
     {
         l->flag = 1;  // Acquire the lock
         l->guard = 0; // Release the guard
+        xtrace(XT_ACQUIRE | XTF_LOCK, currpid, l);
+        LS_ACQUIRE(l);
     }
     else 
     {
+        xtrace(XT_CONTEND | XTF_LOCK, currpid, l);
+        LS_CONTEND(l);
+        // queuetab links us on the lock queue, so we must not be preempted
+        // (and put on the ready list) until park takes us off the CPU
+        intmask mask = disable();
         enqueue(currpid, l->queue);  // Queue the current process
         setpark();  // Set park flag for the current process
         l->guard = 0; // Release the guard
         park();  // Park the current process
+        restore(mask);
+        LS_ACQUIRE(l);  // unlock handed the lock to us
     }
 
     return OK;
@@ -49,16 +61,22 @@ syscall unlock(lock_t *l)
 {
     while(test_and_set(&l->guard, 1))
     {
+        LS_SPIN(l);
+        LS_BACKOFF(l);
         sleepms(QUANTUM);
     }
 
+    xtrace(XT_RELEASE | XTF_LOCK, currpid, l);
+    LS_RELEASE(l);
     if (isempty(l->queue)) 
     {
         l->flag = 0;  // No processes waiting, release the lock
     }
     else 
     {
-        unpark(dequeue(l->queue));  // Unpark the process and make it ready to run
+        pid32 next = dequeue(l->queue);
+        xtrace(XT_ACQUIRE | XTF_LOCK, next, l);  // Lock is handed over
+        unpark(next);  // Unpark the process and make it ready to run
     }
 
     l->guard = 0;  // Release the guard
@@ -79,8 +97,11 @@ syscall park()
     
     if (proctab[currpid].l_flag) 
     {
+        uint64 parkstart = getticks();
+        xtrace(XT_PARK, currpid, 0);
         proctab[currpid].prstate = PR_WAIT;
         resched();  // Yield the CPU to allow other processes to run
+        proctab[currpid].parktime += getticks() - parkstart;
     }
 
     restore(mask);
@@ -90,8 +111,9 @@ syscall park()
 syscall unpark(pid32 processid)
 {
     intmask mask = disable();
+    xtrace(XT_UNPARK, processid, 0);
     proctab[processid].prstate = PR_READY;
-    insert(processid, readylist, proctab[processid].prprio);
+    rq_insert(processid, proctab[processid].prprio);
     proctab[processid].l_flag = FALSE;
     restore(mask);
 
@@ -0,0 +1,187 @@
+/* lockstat.c - lockstat_register, lockstat_contend, lockstat_acquire,	*/
+/*		lockstat_release, lockstat_get, lockstat_reset		*/
+
+#include <xinu.h>
+
+#ifdef	LOCKSTAT
+
+#define	NLSREG	(NSPINLOCKS + NLOCKS + NALOCKS + NPILOCKS)
+
+struct	lsreg	{			/* One initialized lock		*/
+	void	*lsrlock;		/* Address of the lock		*/
+	int32	lsrkind;		/* LS_SL, LS_LOCK, LS_AL, LS_PI	*/
+	lockstat_t *lsrstat;		/* Its statistics		*/
+};
+
+local	struct	lsreg	lsregtab[NLSREG];
+local	int32	nlsreg = 0;		/* Entries used in lsregtab	*/
+
+/*------------------------------------------------------------------------
+ *  lsfind  -  Return the registry entry for a lock, or NULL
+ *------------------------------------------------------------------------
+ */
+local	struct	lsreg	*lsfind(
+	  void		*lock		/* Address of the lock		*/
+	)
+{
+	int32	i;
+
+	for (i = 0; i < nlsreg; i++) {
+		if (lsregtab[i].lsrlock == lock) {
+			return &lsregtab[i];
+		}
+	}
+	return NULL;
+}
+
+/*------------------------------------------------------------------------
+ *  lockstat_register  -  Clear the statistics of a lock being
+ *			    initialized and remember it for reporting
+ *------------------------------------------------------------------------
+ */
+void	lockstat_register(
+	  lockstat_t	*ls,		/* Statistics inside the lock	*/
+	  int32		kind,		/* Lock flavor (LS_*)		*/
+	  void		*lock		/* Address of the lock		*/
+	)
+{
+	intmask	mask;			/* Saved interrupt mask		*/
+	struct	lsreg	*lsr;		/* Registry entry for the lock	*/
+
+	memset(ls, 0, sizeof(lockstat_t));
+
+	mask = disable();
+	lsr = lsfind(lock);		/* Re-initialized: reuse entry	*/
+	if ((lsr == NULL) && (nlsreg < NLSREG)) {
+		lsr = &lsregtab[nlsreg++];
+	}
+	if (lsr != NULL) {
+		lsr->lsrlock = lock;
+		lsr->lsrkind = kind;
+		lsr->lsrstat = ls;
+	}
+	restore(mask);
+}
+
+/*------------------------------------------------------------------------
+ *  lockstat_contend  -  Note that the current process found the lock
+ *			   held and is about to wait for it
+ *------------------------------------------------------------------------
+ */
+void	lockstat_contend(
+	  lockstat_t	*ls		/* Statistics of the lock	*/
+	)
+{
+	ls->contended++;
+	proctab[currpid].lswaitstart = getticks();
+}
+
+/*------------------------------------------------------------------------
+ *  lockstat_acquire  -  Count an acquisition by the current process,
+ *			   charge any wait that preceded it, and start
+ *			   timing the hold
+ *------------------------------------------------------------------------
+ */
+void	lockstat_acquire(
+	  lockstat_t	*ls		/* Statistics of the lock	*/
+	)
+{
+	struct	procent	*prptr;		/* Ptr to process's table entry	*/
+	uint64	now;			/* Current TSC			*/
+	uint64	wait;			/* Cycles spent waiting		*/
+
+	prptr = &proctab[currpid];
+	now = getticks();
+	if (prptr->lswaitstart != 0) {
+		wait = now - prptr->lswaitstart;
+		ls->waittotal += wait;
+		if (wait > ls->waitmax) {
+			ls->waitmax = wait;
+		}
+		prptr->lswaitstart = 0;
+	}
+	ls->acquires++;
+	ls->holdstart = now;
+}
+
+/*------------------------------------------------------------------------
+ *  lockstat_release  -  Add the hold that is ending to the histogram
+ *------------------------------------------------------------------------
+ */
+void	lockstat_release(
+	  lockstat_t	*ls		/* Statistics of the lock	*/
+	)
+{
+	uint64	hold;			/* Cycles the lock was held	*/
+	int32	b;			/* Histogram bucket		*/
+
+	hold = getticks() - ls->holdstart;
+	if ((hold >> 32) != 0) {
+		b = LSNBUCKET - 1;
+	} else if (hold < 1024) {
+		b = 0;
+	} else {
+		b = ((int32)rqbsr((uint32)hold) - 10) / 2 + 1;
+		if (b >= LSNBUCKET) {
+			b = LSNBUCKET - 1;
+		}
+	}
+	ls->holdhist[b]++;
+}
+
+/*------------------------------------------------------------------------
+ *  lockstat_get  -  Copy the statistics of the index'th registered lock,
+ *		       returning its address and flavor, or SYSERR once
+ *		       index runs past the registry
+ *------------------------------------------------------------------------
+ */
+syscall	lockstat_get(
+	  int32		index,		/* Position in the registry	*/
+	  void		**lock,		/* Where to store lock address	*/
+	  int32		*kind,		/* Where to store its flavor	*/
+	  lockstat_t	*ls		/* Where to copy the statistics	*/
+	)
+{
+	intmask	mask;			/* Saved interrupt mask		*/
+	struct	lsreg	*lsr;		/* Registry entry		*/
+
+	mask = disable();
+	if ((index < 0) || (index >= nlsreg) || (ls == NULL)) {
+		restore(mask);
+		return SYSERR;
+	}
+	lsr = &lsregtab[index];
+	if (lock != NULL) {
+		*lock = lsr->lsrlock;
+	}
+	if (kind != NULL) {
+		*kind = lsr->lsrkind;
+	}
+	memcpy(ls, lsr->lsrstat, sizeof(lockstat_t));
+	restore(mask);
+	return OK;
+}
+
+/*------------------------------------------------------------------------
+ *  lockstat_reset  -  Zero the counters of every registered lock; a
+ *		       hold in progress keeps its start time
+ *------------------------------------------------------------------------
+ */
+void	lockstat_reset(void)
+{
+	intmask	mask;			/* Saved interrupt mask		*/
+	lockstat_t *ls;
+	uint64	holdstart;
+	int32	i;
+
+	mask = disable();
+	for (i = 0; i < nlsreg; i++) {
+		ls = lsregtab[i].lsrstat;
+		holdstart = ls->holdstart;
+		memset(ls, 0, sizeof(lockstat_t));
+		ls->holdstart = holdstart;
+	}
+	restore(mask);
+}
+
+#endif
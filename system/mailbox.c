@@ -0,0 +1,127 @@
+/* mailbox.c - mbdeliver, mbtake, mbwait, mbrelease */
+
+#include <xinu.h>
+
+qid16	mbsendq[NPROC];		/* Senders waiting on each mailbox	*/
+
+/*------------------------------------------------------------------------
+ *  mbdeliver  -  Append a message to a mailbox that has room and start
+ *		    the recipient if it is waiting (interrupts disabled)
+ *------------------------------------------------------------------------
+ */
+void	mbdeliver(
+	  pid32		pid,		/* ID of recipient process	*/
+	  umsg32	msg		/* Contents of message		*/
+	)
+{
+	struct	procent *prptr;		/* Ptr to process's table entry	*/
+
+	prptr = &proctab[pid];
+	prptr->prmbox[(prptr->prmbhead + prptr->prmbcount) % MBOXLEN] = msg;
+	prptr->prmbcount++;
+
+	/* If recipient waiting or in timed-wait make it ready */
+
+	if (prptr->prstate == PR_RECV) {
+		ready(pid);
+	} else if (prptr->prstate == PR_RECTIM) {
+		unsleep(pid);
+		ready(pid);
+	}
+}
+
+/*------------------------------------------------------------------------
+ *  mbtake  -  Remove the oldest message from a non-empty mailbox and
+ *		 let one waiting sender retry (interrupts disabled)
+ *------------------------------------------------------------------------
+ */
+umsg32	mbtake(
+	  pid32		pid		/* ID of mailbox owner		*/
+	)
+{
+	struct	procent *prptr;		/* Ptr to process's table entry	*/
+	umsg32	msg;			/* Message to return		*/
+	qid16	q;			/* Owner's sender queue		*/
+
+	prptr = &proctab[pid];
+	msg = prptr->prmbox[prptr->prmbhead];
+	prptr->prmbhead = (prptr->prmbhead + 1) % MBOXLEN;
+	prptr->prmbcount--;
+
+	q = mbsendq[pid];
+	if ((q != 0) && nonempty(q)) {
+		ready(dequeue(q));
+	}
+	return msg;
+}
+
+/*------------------------------------------------------------------------
+ *  mbwait  -  Block the current process until the mailbox of pid has
+ *		 had a message removed; returns SYSERR if pid is killed
+ *		 before the caller runs again, even after the removal
+ *		 (interrupts disabled)
+ *------------------------------------------------------------------------
+ */
+status	mbwait(
+	  pid32		pid		/* ID of mailbox owner		*/
+	)
+{
+	struct	procent *prptr;		/* Ptr to sender's table entry	*/
+	qid16	q;			/* Owner's sender queue		*/
+	uint64	start;			/* Creation time of the owner	*/
+
+	/* Queues are allocated the first time a slot needs one and	*/
+	/*   are kept for whatever process later reuses the slot	*/
+
+	if (mbsendq[pid] == 0) {
+		q = newqueue();
+		if (q == (qid16) SYSERR) {
+			return SYSERR;
+		}
+		mbsendq[pid] = q;
+	}
+
+	prptr = &proctab[currpid];
+	prptr->prsendfail = FALSE;
+	prptr->prstate = PR_SEND;
+	prptr->prwaitfor = pid;
+	start = proctab[pid].starttime;
+	enqueue(currpid, mbsendq[pid]);
+	deadlock_check(currpid);
+	resched();
+
+	/* mbtake takes us off the queue, so mbrelease cannot fail us if	*/
+	/*   the owner dies before we run; check that it still exists	*/
+	/*   and that its slot has not gone to a new process		*/
+
+	if (prptr->prsendfail || isbadpid(pid)
+	    || (proctab[pid].starttime != start)) {
+		return SYSERR;
+	}
+	return OK;
+}
+
+/*------------------------------------------------------------------------
+ *  mbrelease  -  Wake every sender waiting on a mailbox whose owner is
+ *		    being killed; their sends fail (interrupts disabled)
+ *------------------------------------------------------------------------
+ */
+void	mbrelease(
+	  pid32		pid		/* ID of mailbox owner		*/
+	)
+{
+	qid16	q;			/* Owner's sender queue		*/
+	pid32	sender;			/* Waiting sender		*/
+
+	q = mbsendq[pid];
+	if ((q == 0) || isempty(q)) {
+		return;
+	}
+	resched_cntl(DEFER_START);
+	while (nonempty(q)) {
+		sender = dequeue(q);
+		proctab[sender].prsendfail = TRUE;
+		ready(sender);
+	}
+	resched_cntl(DEFER_STOP);
+}
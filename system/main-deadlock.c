@@ -138,21 +138,22 @@ process avoid_circular_wait(al_lock_t *lower_lock, al_lock_t *higher_lock, uint3
 }
 
 syscall sync_log(char *fmt, ...) {
-    intmask mask = disable();
     void *args = __builtin_apply_args();
-    __builtin_apply((void*)kprintf, args, 100);
-    restore(mask);
+    __builtin_apply((void*)klog, args, 100);
     return OK;
 }
 
 void precise_delay(uint32 delay) {
-    uint32 start_time = proctab[currpid].runtime;
-    while ((proctab[currpid].runtime - start_time) < delay);
+    spin_until(getticks() + usecs2ticks(delay * 1000));
 }
 
 process main(void) {
     uint32 time1 = 500, time2 = 300;
 
+    klogstart();
+    wdstart();  // Flags the trylock streaks of Part 2 if they livelock
+    dwstart();  // Sleep wakeups now run outside the clock interrupt
+
     sync_log("\n\n===== PART 1: Deadlock Simulation =====\n\n");
     al_initlock(&lock_a);
     al_initlock(&lock_b);
@@ -232,6 +233,7 @@ process main(void) {
 
     sleep(10);
     sync_log("\nNo Deadlock Detected in Part 4\n");
+    klogflush();
 
     return OK;
 }
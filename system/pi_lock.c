@@ -11,10 +11,34 @@
 #define DEBUG_MODE 0  // Set to 1 to enable debug messages, 0 to disable
 
 #define DEBUG_PRINT(fmt, ...) \
-            do { if (DEBUG_MODE) kprintf(fmt, ##__VA_ARGS__); } while (0)
+            do { if (DEBUG_MODE) klog(fmt, ##__VA_ARGS__); } while (0)
 
 static int pi_count = 0;
 
+// Record that process pid now holds lock l
+static void pi_held_add(pid32 pid, pi_lock_t *l)
+{
+    l->next_held = proctab[pid].piheld;
+    proctab[pid].piheld = l;
+}
+
+// Drop lock l from the list of locks held by process pid
+static void pi_held_remove(pid32 pid, pi_lock_t *l)
+{
+    pi_lock_t **link = &proctab[pid].piheld;
+
+    while (*link != NULL)
+    {
+        if (*link == l)
+        {
+            *link = l->next_held;
+            break;
+        }
+        link = &(*link)->next_held;
+    }
+    l->next_held = NULL;
+}
+
 // Initialize a priority-inheritance lock
 syscall pi_initlock(pi_lock_t *l) 
 {
@@ -26,8 +50,10 @@ syscall pi_initlock(pi_lock_t *l)
 
     l->flag = 0;
     l->curr_holder = 0;
+    l->next_held = NULL;
     l->guard = 0;
     l->queue = newqueue();
+    LS_REGISTER(l, LS_PI);
     pi_count++;
 
     DEBUG_PRINT("Debug: Initialized priority inheritance lock\n");
@@ -41,24 +67,34 @@ syscall pi_lock(pi_lock_t *l)
 
     while (test_and_set(&l->guard, 1))
     {
+        LS_SPIN(l);
+        LS_BACKOFF(l);
         sleepms(QUANTUM);
     }
 
     if (l->flag == 0)
     {
         l->flag = 1;
-        l->guard = 0;
         l->curr_holder = currpid;
+        pi_held_add(currpid, l);
+        l->guard = 0;
+        xtrace(XT_ACQUIRE | XTF_PI, currpid, l);
+        LS_ACQUIRE(l);
 
         DEBUG_PRINT("Debug: Process %d acquired lock\n", currpid);
     }
     else
     {
+        xtrace(XT_CONTEND | XTF_PI, currpid, l);
+        LS_CONTEND(l);
         DEBUG_PRINT("Debug: Lock held, process %d waiting\n", currpid);
+        intmask mask = disable();  // No preemption while on l->queue but not parked
         enqueue(currpid, l->queue);
         pi_setpark();
         l->guard = 0;
         pi_park(l);
+        restore(mask);
+        LS_ACQUIRE(l);  // pi_unlock handed the lock to us
     }
 
     return OK;
@@ -71,12 +107,17 @@ syscall pi_unlock(pi_lock_t *l)
 
     while (test_and_set(&l->guard, 1))
     {
+        LS_SPIN(l);
+        LS_BACKOFF(l);
         sleepms(QUANTUM);
     }
 
+    xtrace(XT_RELEASE | XTF_PI, currpid, l);
+    LS_RELEASE(l);
     if (isempty(l->queue))
     {
         l->flag = 0;
+        pi_held_remove(currpid, l);
         l->guard = 0;
         DEBUG_PRINT("Debug: Lock released with no waiting processes\n");
     }
@@ -96,25 +137,19 @@ void update_priority(pi_lock_t *l)
 
     if (proctab[currpid].prprio > proctab[l->curr_holder].prprio) 
     {
-        qid16 iterator = firstid(readylist);
-        qid16 ready_tail = queuetail(readylist);
-
-        kprintf("priority_change=P%d::%d-%d\n", l->curr_holder, proctab[l->curr_holder].prprio, proctab[currpid].prprio);
+        klog("priority_change=P%d::%d-%d\n", l->curr_holder, proctab[l->curr_holder].prprio, proctab[currpid].prprio);
+        xtrace(XT_PRIO, l->curr_holder, (proctab[l->curr_holder].prprio << 16) | (uint16)proctab[currpid].prprio);
         if (proctab[l->curr_holder].priority == 0) 
         {
             proctab[l->curr_holder].priority = proctab[l->curr_holder].prprio;
         } 
         proctab[l->curr_holder].prprio = proctab[currpid].prprio;
 
-        while (iterator != ready_tail) 
+        // Reposition the holder in constant time if it is waiting to run
+        if (proctab[l->curr_holder].prstate == PR_READY) 
         {
-            if (iterator == l->curr_holder) 
-            {
-                getitem(l->curr_holder);
-                insert(l->curr_holder, readylist, proctab[l->curr_holder].prprio);
-                DEBUG_PRINT("Debug: Lock owner %d priority updated in readylist\n", l->curr_holder);
-            }
-            iterator = queuetab[iterator].qnext;
+            rq_reprio(l->curr_holder, proctab[l->curr_holder].prprio);
+            DEBUG_PRINT("Debug: Lock owner %d priority updated in readylist\n", l->curr_holder);
         }
     }
 }
@@ -127,18 +162,27 @@ void restore_inheritance(pi_lock_t *l)
 
     if (proctab[currpid].priority > 0) 
     {
-        int i;
-        for (i = 0; i < NPROC; i++) 
+        pi_lock_t *held;
+        qid16 iterator;
+
+        // Only waiters on the other locks we still hold can keep us boosted
+        for (held = proctab[currpid].piheld; held != NULL; held = held->next_held) 
         {
-            if (proctab[i].pendingLock->curr_holder == currpid && 
-                proctab[i].prprio > saved_priority && 
-                proctab[i].pendingLock != l) 
+            if (held == l) 
+            {
+                continue;
+            }
+            for (iterator = firstid(held->queue); iterator < NPROC; iterator = queuetab[iterator].qnext) 
             {
-                saved_priority = proctab[i].prprio;
+                if (proctab[iterator].prprio > saved_priority) 
+                {
+                    saved_priority = proctab[iterator].prprio;
+                }
             }
         }
 
-        kprintf("priority_change=P%d::%d-%d\n", currpid, proctab[currpid].prprio, saved_priority);
+        klog("priority_change=P%d::%d-%d\n", currpid, proctab[currpid].prprio, saved_priority);
+        xtrace(XT_PRIO, currpid, (proctab[currpid].prprio << 16) | (uint16)saved_priority);
         proctab[currpid].prprio = saved_priority;
 
         if (saved_priority == proctab[currpid].priority) 
@@ -166,10 +210,14 @@ syscall pi_park(pi_lock_t *l)
 
     if (proctab[currpid].l_flag == TRUE) 
     {
+        uint64 parkstart = getticks();
+        xtrace(XT_PARK, currpid, l);
         proctab[currpid].prstate = PR_WAIT;
         proctab[currpid].pendingLock = l;
         update_priority(l);
+        deadlock_check(currpid);  // Cycles may mix pi locks with other waits
         resched();
+        proctab[currpid].parktime += getticks() - parkstart;
         DEBUG_PRINT("Debug: Process %d parked and waiting for lock\n", currpid);
     }
 
@@ -182,7 +230,10 @@ syscall pi_unpark(pi_lock_t *l)
 {
     intmask mask = disable();
     pid32 next_process = dequeue(l->queue);
+    xtrace(XT_ACQUIRE | XTF_PI, next_process, l);  // Lock is handed over
+    pi_held_remove(currpid, l);
     l->curr_holder = next_process;
+    pi_held_add(next_process, l);
     proctab[next_process].pendingLock = NULL;
 
     pri16 current_priority = proctab[currpid].prprio;
@@ -190,14 +241,16 @@ syscall pi_unpark(pi_lock_t *l)
 
     if (proctab[next_process].prprio != current_priority)
     {
-        kprintf("priority_change=P%d::%d-%d\n", next_process, proctab[next_process].prprio, current_priority);
+        klog("priority_change=P%d::%d-%d\n", next_process, proctab[next_process].prprio, current_priority);
+        xtrace(XT_PRIO, next_process, (proctab[next_process].prprio << 16) | (uint16)current_priority);
         proctab[next_process].priority = proctab[next_process].prprio;
         proctab[next_process].prprio = current_priority;
     }
 
     proctab[next_process].l_flag = FALSE;
+    xtrace(XT_UNPARK, next_process, l);
     proctab[next_process].prstate = PR_READY;
-    insert(next_process, readylist, proctab[next_process].prprio);
+    rq_insert(next_process, proctab[next_process].prprio);
     l->guard = 0;
 
     DEBUG_PRINT("Debug: Process %d unparked and set to ready\n", next_process);
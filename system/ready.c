@@ -0,0 +1,62 @@
+/* ready.c - ready, print_ready_list */
+
+#include <xinu.h>
+
+qid16	readylist;			/* Index of ready list		*/
+
+/*------------------------------------------------------------------------
+ *  ready  -  Make a process eligible for CPU service
+ *------------------------------------------------------------------------
+ */
+status	ready(
+	  pid32		pid		/* ID of process to make ready	*/
+	)
+{
+	register struct procent *prptr;
+
+	if (isbadpid(pid)) {
+		return SYSERR;
+	}
+
+	/* Set process state to indicate ready and add to ready list */
+
+	prptr = &proctab[pid];
+	prptr->prstate = PR_READY;
+	rq_insert(pid, prptr->prprio);
+	resched();
+
+	return OK;
+}
+
+/*------------------------------------------------------------------------
+ *  print_ready_list  -  Print the ready processes in the order resched
+ *			   would choose them
+ *------------------------------------------------------------------------
+ */
+syscall	print_ready_list(void)
+{
+	intmask	mask;			/* Saved interrupt mask		*/
+	int32	w, b;			/* Bitmap word and bit		*/
+	pid32	head, pid;		/* Walks one priority level	*/
+
+	mask = disable();
+	kprintf("ready list:");
+	for (w = RQNWORD - 1; w >= 0; w--) {
+		if (readyq.rqbits[w] == 0) {
+			continue;
+		}
+		for (b = RQWBITS - 1; b >= 0; b--) {
+			if ((readyq.rqbits[w] & (1 << b)) == 0) {
+				continue;
+			}
+			head = pid = readyq.rqhead[(w << 5) + b];
+			do {
+				kprintf(" P%d(%d)", pid, queuetab[pid].qkey);
+				pid = queuetab[pid].qnext;
+			} while (pid != head);
+		}
+	}
+	kprintf("\n");
+	restore(mask);
+	return OK;
+}
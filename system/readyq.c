@@ -0,0 +1,170 @@
+/* readyq.c - rq_insert, rq_remove, rq_dequeue, rq_reprio, rq_firstid,	*/
+/*		rq_firstkey						*/
+
+#include <xinu.h>
+
+struct	rqinfo	readyq;		/* Ready list (all levels empty)	*/
+
+/*------------------------------------------------------------------------
+ *  rq_setbit  -  Mark a priority level nonempty in all bitmap levels
+ *------------------------------------------------------------------------
+ */
+local	void	rq_setbit(
+	  int32		p		/* Priority level		*/
+	)
+{
+	int32	w = p >> 5;		/* Leaf word holding level p	*/
+
+	readyq.rqbits[w] |= (1 << (p & 0x1f));
+	readyq.rqsum[w >> 5] |= (1 << (w & 0x1f));
+	readyq.rqtop |= (1 << (w >> 5));
+}
+
+/*------------------------------------------------------------------------
+ *  rq_clrbit  -  Mark a priority level empty, clearing summary bits
+ *		    that no longer cover any nonempty level
+ *------------------------------------------------------------------------
+ */
+local	void	rq_clrbit(
+	  int32		p		/* Priority level		*/
+	)
+{
+	int32	w = p >> 5;		/* Leaf word holding level p	*/
+
+	readyq.rqbits[w] &= ~(1 << (p & 0x1f));
+	if (readyq.rqbits[w] == 0) {
+		readyq.rqsum[w >> 5] &= ~(1 << (w & 0x1f));
+		if (readyq.rqsum[w >> 5] == 0) {
+			readyq.rqtop &= ~(1 << (w >> 5));
+		}
+	}
+}
+
+/*------------------------------------------------------------------------
+ *  rq_insert  -  Add a process at the tail of its priority level, so
+ *		    equal priorities are served in FIFO order exactly as
+ *		    insert() on the old ordered ready list did
+ *		    (assumes interrupts are disabled)
+ *------------------------------------------------------------------------
+ */
+status	rq_insert(
+	  pid32		pid,		/* ID of process to insert	*/
+	  int32		key		/* Priority of the process	*/
+	)
+{
+	int32	p;			/* Priority level for key	*/
+	pid32	head, tail;		/* Ends of the level's list	*/
+
+	if (isbadpid(pid)) {
+		return SYSERR;
+	}
+
+	p = rqindex(key);
+	queuetab[pid].qkey = key;
+	if (rqtest(p)) {
+		head = readyq.rqhead[p];
+		tail = queuetab[head].qprev;
+		queuetab[pid].qnext = head;
+		queuetab[pid].qprev = tail;
+		queuetab[tail].qnext = pid;
+		queuetab[head].qprev = pid;
+	} else {
+		readyq.rqhead[p] = pid;
+		queuetab[pid].qnext = pid;
+		queuetab[pid].qprev = pid;
+		rq_setbit(p);
+	}
+	readyq.rqcount++;
+	return OK;
+}
+
+/*------------------------------------------------------------------------
+ *  rq_remove  -  Unlink a ready process from its priority level
+ *		    (assumes interrupts are disabled)
+ *------------------------------------------------------------------------
+ */
+pid32	rq_remove(
+	  pid32		pid		/* ID of process to remove	*/
+	)
+{
+	int32	p;			/* Priority level of process	*/
+	pid32	prev, next;		/* Neighbors in the level	*/
+
+	p = rqindex(queuetab[pid].qkey);
+	next = queuetab[pid].qnext;
+	if (next == pid) {		/* Only process at this level	*/
+		rq_clrbit(p);
+	} else {
+		prev = queuetab[pid].qprev;
+		queuetab[prev].qnext = next;
+		queuetab[next].qprev = prev;
+		if (readyq.rqhead[p] == pid) {
+			readyq.rqhead[p] = next;
+		}
+	}
+	readyq.rqcount--;
+	return pid;
+}
+
+/*------------------------------------------------------------------------
+ *  rq_firstid  -  Return the highest priority ready process without
+ *		     removing it, or EMPTY if no process is ready
+ *------------------------------------------------------------------------
+ */
+pid32	rq_firstid(void)
+{
+	uint32	i, j, k;		/* Bit found at each level	*/
+
+	if (rqisempty()) {
+		return EMPTY;
+	}
+	i = rqbsr(readyq.rqtop);
+	j = (i << 5) + rqbsr(readyq.rqsum[i]);
+	k = (j << 5) + rqbsr(readyq.rqbits[j]);
+	return readyq.rqhead[k];
+}
+
+/*------------------------------------------------------------------------
+ *  rq_firstkey  -  Return the priority of the first ready process, or
+ *		      MINKEY when the list is empty (as firstkey() does)
+ *------------------------------------------------------------------------
+ */
+int32	rq_firstkey(void)
+{
+	pid32	pid;			/* First ready process		*/
+
+	pid = rq_firstid();
+	if (pid == EMPTY) {
+		return (int32)MINKEY;
+	}
+	return queuetab[pid].qkey;
+}
+
+/*------------------------------------------------------------------------
+ *  rq_dequeue  -  Remove and return the highest priority ready process
+ *------------------------------------------------------------------------
+ */
+pid32	rq_dequeue(void)
+{
+	pid32	pid;			/* Process being removed	*/
+
+	pid = rq_firstid();
+	if (pid == EMPTY) {
+		return EMPTY;
+	}
+	return rq_remove(pid);
+}
+
+/*------------------------------------------------------------------------
+ *  rq_reprio  -  Move a ready process to the tail of a new priority
+ *		    level
+ *------------------------------------------------------------------------
+ */
+status	rq_reprio(
+	  pid32		pid,		/* ID of a ready process	*/
+	  int32		key		/* New priority			*/
+	)
+{
+	rq_remove(pid);
+	return rq_insert(pid, key);
+}
@@ -0,0 +1,25 @@
+/* receive.c - receive */
+
+#include <xinu.h>
+
+/*------------------------------------------------------------------------
+ *  receive  -  Wait for a message and return the oldest one to the
+ *		caller
+ *------------------------------------------------------------------------
+ */
+umsg32	receive(void)
+{
+	intmask	mask;			/* Saved interrupt mask		*/
+	struct	procent *prptr;		/* Ptr to process's table entry	*/
+	umsg32	msg;			/* Message to return		*/
+
+	mask = disable();
+	prptr = &proctab[currpid];
+	while (prptr->prmbcount == 0) {	/* sendbuf also wakes us*/
+		prptr->prstate = PR_RECV;
+		resched();		/* Block until message arrives	*/
+	}
+	msg = mbtake(currpid);		/* Retrieve oldest message	*/
+	restore(mask);
+	return msg;
+}
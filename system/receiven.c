@@ -0,0 +1,38 @@
+/* receiven.c - receiven */
+
+#include <xinu.h>
+
+/*------------------------------------------------------------------------
+ *  receiven  -  Wait for at least one message, then return up to n of
+ *		 the waiting messages, oldest first, and their count
+ *------------------------------------------------------------------------
+ */
+int32	receiven(
+	  umsg32	*msgs,		/* Array to hold the messages	*/
+	  int32		n		/* Size of the array		*/
+	)
+{
+	intmask	mask;			/* Saved interrupt mask		*/
+	struct	procent *prptr;		/* Ptr to process's table entry	*/
+	int32	i;			/* Messages retrieved		*/
+
+	if ((msgs == NULL) || (n <= 0)) {
+		return SYSERR;
+	}
+	mask = disable();
+	prptr = &proctab[currpid];
+	while (prptr->prmbcount == 0) {	/* sendbuf also wakes us*/
+		prptr->prstate = PR_RECV;
+		resched();		/* Block until message arrives	*/
+	}
+
+	/* Senders woken as space frees up run once we are done */
+
+	resched_cntl(DEFER_START);
+	for (i = 0; (i < n) && (prptr->prmbcount > 0); i++) {
+		msgs[i] = mbtake(currpid);
+	}
+	resched_cntl(DEFER_STOP);
+	restore(mask);
+	return i;
+}
@@ -0,0 +1,30 @@
+/* recvclr.c - recvclr */
+
+#include <xinu.h>
+
+/*------------------------------------------------------------------------
+ *  recvclr  -  Empty the mailbox, returning the oldest message if one
+ *		was waiting, or OK otherwise
+ *------------------------------------------------------------------------
+ */
+umsg32	recvclr(void)
+{
+	intmask	mask;			/* Saved interrupt mask		*/
+	struct	procent *prptr;		/* Ptr to process's table entry	*/
+	umsg32	msg;			/* Message to return		*/
+
+	mask = disable();
+	prptr = &proctab[currpid];
+	if (prptr->prmbcount == 0) {
+		restore(mask);
+		return OK;
+	}
+	resched_cntl(DEFER_START);
+	msg = mbtake(currpid);
+	while (prptr->prmbcount > 0) {
+		mbtake(currpid);
+	}
+	resched_cntl(DEFER_STOP);
+	restore(mask);
+	return msg;
+}
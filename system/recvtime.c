@@ -0,0 +1,43 @@
+/* recvtime.c - recvtime */
+
+#include <xinu.h>
+
+/*------------------------------------------------------------------------
+ *  recvtime  -  Wait specified time to receive a message and return
+ *------------------------------------------------------------------------
+ */
+umsg32	recvtime(
+	  int32		maxwait		/* Ticks to wait before timeout */
+        )
+{
+	intmask	mask;			/* Saved interrupt mask		*/
+	struct	procent	*prptr;		/* Tbl entry of current process	*/
+	umsg32	msg;			/* Message to return		*/
+
+	if (maxwait < 0) {
+		return SYSERR;
+	}
+	mask = disable();
+
+	/* Schedule wakeup and place process in timed-receive state */
+
+	prptr = &proctab[currpid];
+	if (prptr->prmbcount == 0) {	/* Delay if no message waiting	*/
+		if (tw_insert(currpid, maxwait) == SYSERR) {
+			restore(mask);
+			return SYSERR;
+		}
+		prptr->prstate = PR_RECTIM;
+		resched();
+	}
+
+	/* Either message arrived or timer expired */
+
+	if (prptr->prmbcount > 0) {
+		msg = mbtake(currpid);	/* Retrieve oldest message	*/
+	} else {
+		msg = TIMEOUT;
+	}
+	restore(mask);
+	return msg;
+}
@@ -0,0 +1,144 @@
+/* resched.c - resched, resched_cntl, preempt_disable, preempt_enable */
+
+#include <xinu.h>
+
+struct	defer	Defer;
+
+/*------------------------------------------------------------------------
+ *  resched  -  Reschedule processor to highest priority eligible process
+ *------------------------------------------------------------------------
+ */
+void	resched(void)		/* Assumes interrupts are disabled	*/
+{
+	struct procent *ptold;	/* Ptr to table entry for old process	*/
+	struct procent *ptnew;	/* Ptr to table entry for new process	*/
+	uint64	now;		/* TSC at the switch			*/
+
+	/* If rescheduling is deferred, record attempt and return */
+
+	if (Defer.ndefers > 0) {
+		Defer.attempt = TRUE;
+		return;
+	}
+
+#ifdef	TICKLESS
+	/* Leaving an idle one-shot period early: catch up the clock	*/
+	/*   and resume periodic ticks so the next process is preempted	*/
+
+	if (clkoneshot != 0) {
+		clksync();
+	}
+#endif
+
+	/* Point to process table entry for the current (old) process */
+
+	ptold = &proctab[currpid];
+
+	if (ptold->prstate == PR_CURR) {  /* Process remains eligible */
+
+		/* With preemption disabled it keeps the CPU; the switch	*/
+		/*   happens in preempt_enable once the count reaches zero	*/
+
+		if (ptold->prnopreempt > 0) {
+			ptold->prpreemptpend = TRUE;
+			return;
+		}
+		if (ptold->prprio > rq_firstkey()) {
+			return;
+		}
+
+		/* Old process will no longer remain current */
+
+		ptold->prstate = PR_READY;
+		rq_insert(currpid, ptold->prprio);
+		ptold->num_invsw++;
+	} else {
+		ptold->num_volsw++;
+	}
+
+	/* Force context switch to highest priority ready process */
+
+	currpid = rq_dequeue();
+	ptnew = &proctab[currpid];
+	ptnew->prstate = PR_CURR;
+	preempt = QUANTUM;		/* Reset time slice for process	*/
+
+	/* Charge the old process for its time on the CPU */
+
+	now = getticks();
+	ptold->cputime += now - ptold->swintime;
+	ptnew->swintime = now;
+	ptnew->num_ctxsw++;
+	xtrace(XT_SWITCH, ptold - proctab, currpid);
+
+	ctxsw(&ptold->prstkptr, &ptnew->prstkptr);
+
+	/* Old process returns here when resumed */
+
+	return;
+}
+
+/*------------------------------------------------------------------------
+ *  resched_cntl  -  Control whether rescheduling is deferred or allowed
+ *------------------------------------------------------------------------
+ */
+status	resched_cntl(		/* Assumes interrupts are disabled	*/
+	  int32	defer		/* Either DEFER_START or DEFER_STOP	*/
+	)
+{
+	switch (defer) {
+
+	    case DEFER_START:	/* Handle a deferral request */
+
+		if (Defer.ndefers++ == 0) {
+			Defer.attempt = FALSE;
+		}
+		return OK;
+
+	    case DEFER_STOP:	/* Handle end of deferral */
+		if (Defer.ndefers <= 0) {
+			return SYSERR;
+		}
+		if ( (--Defer.ndefers == 0) && Defer.attempt ) {
+			resched();
+		}
+		return OK;
+
+	    default:
+		return SYSERR;
+	}
+}
+
+/*------------------------------------------------------------------------
+ *  preempt_disable  -  Keep the current process on the CPU until it
+ *			  blocks or calls preempt_enable; calls nest
+ *------------------------------------------------------------------------
+ */
+void	preempt_disable(void)
+{
+	proctab[currpid].prnopreempt++;
+}
+
+/*------------------------------------------------------------------------
+ *  preempt_enable  -  Undo one preempt_disable, and make any reschedule
+ *			 that was held off once the count reaches zero
+ *------------------------------------------------------------------------
+ */
+void	preempt_enable(void)
+{
+	struct	procent	*prptr;		/* Ptr to process's table entry	*/
+	intmask	mask;			/* Saved interrupt mask		*/
+
+	/* Only the process itself changes its count, and an interrupt	*/
+	/*   that sees it at zero reschedules directly, so the pending	*/
+	/*   flag needs to be checked with interrupts disabled only	*/
+	/*   when it is set						*/
+
+	prptr = &proctab[currpid];
+	if ((--prptr->prnopreempt == 0) && prptr->prpreemptpend) {
+		mask = disable();
+		prptr->prpreemptpend = FALSE;
+		resched();
+		restore(mask);
+	}
+}
@@ -0,0 +1,72 @@
+/* semcreate.c - semcreate, semmutex, newsem */
+
+#include <xinu.h>
+
+local	sid32	newsem(void);
+
+/*------------------------------------------------------------------------
+ *  semcreate  -  Create a new semaphore and return the ID to the caller
+ *------------------------------------------------------------------------
+ */
+sid32	semcreate(
+	  int32		count		/* Initial semaphore count	*/
+	)
+{
+	intmask	mask;			/* Saved interrupt mask		*/
+	sid32	sem;			/* Semaphore ID to return	*/
+
+	mask = disable();
+
+	if (count < 0 || ((sem=newsem())==SYSERR)) {
+		restore(mask);
+		return SYSERR;
+	}
+	semtab[sem].scount = count;	/* Initialize table entry	*/
+	semtab[sem].smutex = FALSE;	/* Not owned; see semmutex	*/
+	semtab[sem].sholder = -1;
+	semtab[sem].snextheld = -1;
+
+	restore(mask);
+	return sem;
+}
+
+/*------------------------------------------------------------------------
+ *  semmutex  -  Create a semaphore used as a mutex: its count starts at
+ *		 1 and the process holding the unit is tracked
+ *------------------------------------------------------------------------
+ */
+sid32	semmutex(void)
+{
+	intmask	mask;			/* Saved interrupt mask		*/
+	sid32	sem;			/* Semaphore ID to return	*/
+
+	mask = disable();
+	sem = semcreate(1);
+	if (sem != SYSERR) {
+		semtab[sem].smutex = TRUE;
+	}
+	restore(mask);
+	return sem;
+}
+
+/*------------------------------------------------------------------------
+ *  newsem  -  Allocate an unused semaphore and return its index
+ *------------------------------------------------------------------------
+ */
+local	sid32	newsem(void)
+{
+	static	sid32	nextsem = 0;	/* Next semaphore index to try	*/
+	sid32	sem;			/* Semaphore ID to return	*/
+	int32	i;			/* Iterate through # entries	*/
+
+	for (i=0 ; i<NSEM ; i++) {
+		sem = nextsem++;
+		if (nextsem >= NSEM)
+			nextsem = 0;
+		if (semtab[sem].sstate == S_FREE) {
+			semtab[sem].sstate = S_USED;
+			return sem;
+		}
+	}
+	return SYSERR;
+}
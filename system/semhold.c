@@ -0,0 +1,74 @@
+/* semhold.c - semhold, semunhold, semrelease */
+
+#include <xinu.h>
+
+/*------------------------------------------------------------------------
+ *  semhold  -  Record that process pid holds mutex semaphore sem (called
+ *		with interrupts disabled)
+ *------------------------------------------------------------------------
+ */
+void	semhold(
+	  sid32		sem,		/* Mutex semaphore taken	*/
+	  pid32		pid		/* Process that took it		*/
+	)
+{
+	struct	sentry	*semptr;	/* Ptr to semaphore table entry	*/
+	struct	procent	*prptr;		/* Ptr to holder's table entry	*/
+
+	semptr = &semtab[sem];
+	prptr = &proctab[pid];
+	semptr->sholder = pid;
+	semptr->snextheld = prptr->prmutex;
+	prptr->prmutex = sem;
+}
+
+/*------------------------------------------------------------------------
+ *  semunhold  -  Clear the holder of mutex semaphore sem, if it has one
+ *		  (called with interrupts disabled)
+ *------------------------------------------------------------------------
+ */
+void	semunhold(
+	  sid32		sem		/* Mutex semaphore released	*/
+	)
+{
+	struct	sentry	*semptr;	/* Ptr to semaphore table entry	*/
+	sid32	*prev;			/* Link that names sem		*/
+
+	semptr = &semtab[sem];
+	if (isbadpid(semptr->sholder)) {
+		return;
+	}
+
+	/* A process holds few mutexes at once, so the walk is short	*/
+
+	prev = &proctab[semptr->sholder].prmutex;
+	while (*prev != -1) {
+		if (*prev == sem) {
+			*prev = semptr->snextheld;
+			break;
+		}
+		prev = &semtab[*prev].snextheld;
+	}
+	semptr->sholder = -1;
+}
+
+/*------------------------------------------------------------------------
+ *  semrelease  -  Clear the holder of every mutex semaphore that process
+ *		   pid holds as it is killed, so a later process given the
+ *		   same ID is not taken for the holder (called with
+ *		   interrupts disabled)
+ *------------------------------------------------------------------------
+ */
+void	semrelease(
+	  pid32		pid		/* ID of process being killed	*/
+	)
+{
+	struct	procent	*prptr;		/* Ptr to process's table entry	*/
+	sid32	sem;			/* Mutex semaphore it holds	*/
+
+	prptr = &proctab[pid];
+	while ((sem = prptr->prmutex) != -1) {
+		prptr->prmutex = semtab[sem].snextheld;
+		semtab[sem].sholder = -1;
+	}
+}
@@ -3,7 +3,8 @@
 #include <xinu.h>
 
 /*------------------------------------------------------------------------
- *  send  -  Pass a message to a process and start recipient if waiting
+ *  send  -  Pass a message to a process and start recipient if waiting;
+ *	     if the recipient's mailbox is full, wait for it to receive
  *------------------------------------------------------------------------
  */
 syscall	send(
@@ -20,22 +21,16 @@ syscall	send(
 		return SYSERR;
 	}
 
-	prptr = &proctab[pid];
-	while(prptr->prhasmsg) {
-		resched();
-		//return SYSERR;
-	}
-	prptr->prmsg = msg;		/* Deliver message		*/
-	prptr->prhasmsg = TRUE;		/* Indicate message is waiting	*/
+	/* A process cannot wait for itself to make room */
 
-	/* If recipient waiting or in timed-wait make it ready */
-
-	if (prptr->prstate == PR_RECV) {
-		ready(pid);
-	} else if (prptr->prstate == PR_RECTIM) {
-		unsleep(pid);
-		ready(pid);
+	prptr = &proctab[pid];
+	while (prptr->prmbcount >= MBOXLEN) {
+		if ((pid == currpid) || (mbwait(pid) == SYSERR)) {
+			restore(mask);
+			return SYSERR;
+		}
 	}
+	mbdeliver(pid, msg);		/* Also starts a waiting recipient*/
 	restore(mask);		/* Restore interrupts */
 	return OK;
 }
@@ -0,0 +1,106 @@
+/* sendbuf.c - sendbuf, recvbuf, bufreclaim */
+
+#include <xinu.h>
+
+/* Buffers sent to each process and not yet received, oldest first	*/
+
+local	struct	bphdr	*bufinhead[NPROC];
+local	struct	bphdr	*bufintail[NPROC];
+
+/*------------------------------------------------------------------------
+ *  sendbuf  -  Hand a pool buffer owned by the caller to another
+ *		process without copying it; the caller must not touch
+ *		the buffer afterward
+ *------------------------------------------------------------------------
+ */
+syscall	sendbuf(
+	  pid32		pid,		/* ID of recipient process	*/
+	  char		*buf		/* Buffer obtained from getbuf	*/
+	)
+{
+	intmask	mask;			/* Saved interrupt mask		*/
+	struct	bphdr	*hdr;		/* Header of the buffer		*/
+
+	mask = disable();
+	if (isbadpid(pid) || (buf == NULL)) {
+		restore(mask);
+		return SYSERR;
+	}
+	hdr = bufhdr(buf);
+	if ((hdr->bhpool < 0) || (hdr->bhpool >= nbpools)
+	    || (hdr->bhowner != currpid) || hdr->bhqueued) {
+		restore(mask);
+		return SYSERR;
+	}
+
+	/* Ownership passes now, so the buffer is reclaimed if the	*/
+	/*   recipient dies before receiving it				*/
+
+	hdr->bhowner = pid;
+	hdr->bhqueued = TRUE;
+	hdr->bhnext = NULL;
+	if (bufinhead[pid] == NULL) {
+		bufinhead[pid] = hdr;
+	} else {
+		bufintail[pid]->bhnext = hdr;
+	}
+	bufintail[pid] = hdr;
+
+	if (proctab[pid].prstate == PR_RECV) {
+		ready(pid);
+	} else if (proctab[pid].prstate == PR_RECTIM) {
+		unsleep(pid);
+		ready(pid);
+	}
+	restore(mask);
+	return OK;
+}
+
+/*------------------------------------------------------------------------
+ *  recvbuf  -  Wait for a buffer sent with sendbuf and return it; the
+ *		caller owns the buffer and eventually calls freebuf
+ *------------------------------------------------------------------------
+ */
+char	*recvbuf(void)
+{
+	intmask	mask;			/* Saved interrupt mask		*/
+	struct	bphdr	*hdr;		/* Header of the buffer		*/
+
+	mask = disable();
+
+	/* Ordinary messages also end a PR_RECV wait, so check again	*/
+
+	while (bufinhead[currpid] == NULL) {
+		proctab[currpid].prstate = PR_RECV;
+		resched();
+	}
+	hdr = bufinhead[currpid];
+	bufinhead[currpid] = hdr->bhnext;
+	hdr->bhnext = NULL;
+	hdr->bhqueued = FALSE;
+	restore(mask);
+	return (char *)(hdr + 1);
+}
+
+/*------------------------------------------------------------------------
+ *  bufreclaim  -  Return to their pools the buffers sent to a process
+ *		     that is being killed (interrupts disabled)
+ *------------------------------------------------------------------------
+ */
+void	bufreclaim(
+	  pid32		pid		/* ID of process being killed	*/
+	)
+{
+	struct	bphdr	*hdr;		/* Header of the buffer		*/
+
+	if (bufinhead[pid] == NULL) {
+		return;
+	}
+	resched_cntl(DEFER_START);
+	while ((hdr = bufinhead[pid]) != NULL) {
+		bufinhead[pid] = hdr->bhnext;
+		hdr->bhqueued = FALSE;
+		freebuf((char *)(hdr + 1));
+	}
+	resched_cntl(DEFER_STOP);
+}
@@ -0,0 +1,47 @@
+/* sendn.c - sendn */
+
+#include <xinu.h>
+
+/*------------------------------------------------------------------------
+ *  sendn  -  Pass n messages to a process, waiting whenever its mailbox
+ *	      fills; returns the number sent, or SYSERR if none could be
+ *------------------------------------------------------------------------
+ */
+int32	sendn(
+	  pid32		pid,		/* ID of recipient process	*/
+	  umsg32	*msgs,		/* Messages to send, in order	*/
+	  int32		n		/* Number of messages		*/
+	)
+{
+	intmask	mask;			/* Saved interrupt mask		*/
+	struct	procent *prptr;		/* Ptr to process's table entry	*/
+	int32	i;			/* Messages sent so far		*/
+
+	mask = disable();
+	if (isbadpid(pid) || (msgs == NULL) || (n < 0)) {
+		restore(mask);
+		return SYSERR;
+	}
+	prptr = &proctab[pid];
+
+	/* The recipient only runs when the mailbox fills or at the end	*/
+
+	resched_cntl(DEFER_START);
+	for (i = 0; i < n; i++) {
+		if (prptr->prmbcount >= MBOXLEN) {
+			resched_cntl(DEFER_STOP);
+			while (prptr->prmbcount >= MBOXLEN) {
+				if ((pid == currpid) ||
+				    (mbwait(pid) == SYSERR)) {
+					restore(mask);
+					return (i > 0) ? i : SYSERR;
+				}
+			}
+			resched_cntl(DEFER_START);
+		}
+		mbdeliver(pid, msgs[i]);
+	}
+	resched_cntl(DEFER_STOP);
+	restore(mask);
+	return n;
+}
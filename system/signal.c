@@ -0,0 +1,39 @@
+/* signal.c - signal */
+
+#include <xinu.h>
+
+/*------------------------------------------------------------------------
+ *  signal  -  Signal a semaphore, releasing a process if one is waiting
+ *------------------------------------------------------------------------
+ */
+syscall	signal(
+	  sid32		sem		/* ID of semaphore to signal	*/
+	)
+{
+	intmask mask;			/* Saved interrupt mask		*/
+	struct	sentry *semptr;		/* Ptr to sempahore table entry	*/
+	pid32	pid;			/* Waiter that gets the unit	*/
+
+	mask = disable();
+	if (isbadsem(sem)) {
+		restore(mask);
+		return SYSERR;
+	}
+	semptr= &semtab[sem];
+	if (semptr->sstate == S_FREE) {
+		restore(mask);
+		return SYSERR;
+	}
+	if ((semptr->scount++) < 0) {	/* Release a waiting process */
+		pid = dequeue(semptr->squeue);
+		if (semptr->smutex) {
+			semunhold(sem);		/* Mutex passes to it	*/
+			semhold(sem, pid);
+		}
+		ready(pid);
+	} else if (semptr->smutex) {
+		semunhold(sem);
+	}
+	restore(mask);
+	return OK;
+}
@@ -4,7 +4,8 @@
 //#include "../include/lock.h"
 
 /*------------------------------------------------------------------------
- *  spinlock  -  Initialization, lock and an unlock functions of sl_lock_t
+ *  spinlock  -  Initialization, lock and an unlock functions of sl_lock_t,
+ *              and the variants that also disable interrupts
  *------------------------------------------------------------------------
  */
 
@@ -18,17 +19,78 @@ syscall sl_initlock(sl_lock_t *l)
     }
     sl_lock_count++;
     l->flag = 0;  // Ensure lock is unlocked initially
+    LS_REGISTER(l, LS_SL);
     return OK;
 }
 
 syscall sl_lock(sl_lock_t *l)
 {
-    while (test_and_set(&l->flag, 1));
+    SL_NOPREEMPT();  // Before the test_and_set, so no tick lands between it and the count
+    if (test_and_set(&l->flag, 1))
+    {
+        xtrace(XT_CONTEND | XTF_SL, currpid, l);
+        LS_CONTEND(l);
+        proctab[currpid].prspinon = l;  // For the watchdog; contended path only
+        do
+        {
+            // A spinner stays preemptible, so its quantum still ends if
+            // the holder blocked and needs the CPU back to release
+            SL_PREEMPT();
+            LS_SPIN(l);
+            SL_NOPREEMPT();
+        } while (test_and_set(&l->flag, 1));
+        proctab[currpid].prspinon = NULL;
+    }
+    xtrace(XT_ACQUIRE | XTF_SL, currpid, l);
+    LS_ACQUIRE(l);
     return OK;
 }
 
 syscall sl_unlock(sl_lock_t *l)
 {    
+    xtrace(XT_RELEASE | XTF_SL, currpid, l);
+    LS_RELEASE(l);
     l->flag = 0;  // Release the lock
+    SL_PREEMPT();  // Runs a reschedule the timer held off while we held it
+    return OK;
+}
+
+// Locks shared with an interrupt handler. Interrupts stay off while the
+// lock is held, so the handler can never find it held by the code it
+// interrupted; every user of such a lock must take it this way.
+intmask sl_lock_irqsave(sl_lock_t *l)
+{
+    intmask mask = disable();
+
+    SL_NOPREEMPT();
+    if (test_and_set(&l->flag, 1))
+    {
+        xtrace(XT_CONTEND | XTF_SL, currpid, l);
+        LS_CONTEND(l);
+        proctab[currpid].prspinon = l;
+        do
+        {
+            // The holder cannot run while we spin with interrupts off,
+            // so give it a window on every attempt
+            SL_PREEMPT();
+            restore(mask);
+            LS_SPIN(l);
+            mask = disable();
+            SL_NOPREEMPT();
+        } while (test_and_set(&l->flag, 1));
+        proctab[currpid].prspinon = NULL;
+    }
+    xtrace(XT_ACQUIRE | XTF_SL, currpid, l);
+    LS_ACQUIRE(l);
+    return mask;
+}
+
+syscall sl_unlock_irqrestore(sl_lock_t *l, intmask mask)
+{
+    xtrace(XT_RELEASE | XTF_SL, currpid, l);
+    LS_RELEASE(l);
+    l->flag = 0;
+    SL_PREEMPT();
+    restore(mask);  // Interrupts back as they were before sl_lock_irqsave
     return OK;
 }
@@ -0,0 +1,120 @@
+/* stkcache.c - stkcget, stkcput, stkcflush */
+
+#include <xinu.h>
+
+struct	stkclass {			/* Cached stacks of one size	*/
+	uint32	scsize;			/* Stack size (rounded), 0 if	*/
+					/*   the class is unused	*/
+	int32	sccount;		/* Stacks held in the class	*/
+	char	*sctop;			/* Most recently freed stack;	*/
+					/*   each top word links to the	*/
+					/*   next one			*/
+};
+
+local	struct	stkclass stkctab[STKCNCLASS];
+local	uint32	stkcbytes = 0;		/* Memory held in the cache	*/
+uint32	stkchits = 0;
+uint32	stkcmisses = 0;
+
+/*------------------------------------------------------------------------
+ *  stkcget  -  Obtain a stack of nbytes (already rounded with roundmb)
+ *		  from the cache, or from getstk if none is cached
+ *		  (assumes interrupts are disabled)
+ *------------------------------------------------------------------------
+ */
+char	*stkcget(
+	  uint32	nbytes		/* Size of stack in bytes	*/
+	)
+{
+	struct	stkclass *scptr;	/* Ptr to size class		*/
+	char	*saddr;			/* Highest word of the stack	*/
+	int32	i;
+
+	for (i = 0; i < STKCNCLASS; i++) {
+		scptr = &stkctab[i];
+		if ((scptr->scsize == nbytes) && (scptr->sccount > 0)) {
+			saddr = scptr->sctop;
+			scptr->sctop = *(char **)saddr;
+			scptr->sccount--;
+			stkcbytes -= nbytes;
+			stkchits++;
+			return saddr;
+		}
+	}
+	stkcmisses++;
+	saddr = getstk(nbytes);
+	if ((saddr == (char *)SYSERR) && (stkcbytes > 0)) {
+		stkcflush();		/* Cached stacks may be in the	*/
+		saddr = getstk(nbytes);	/*   way of a larger request	*/
+	}
+	return saddr;
+}
+
+/*------------------------------------------------------------------------
+ *  stkcput  -  Keep the stack of a terminated process for reuse, or
+ *		  free it if its class is full or the cache is at its
+ *		  limit (assumes interrupts are disabled)
+ *------------------------------------------------------------------------
+ */
+void	stkcput(
+	  char		*saddr,		/* Highest word of the stack	*/
+	  uint32	nbytes		/* Size as recorded by create	*/
+	)
+{
+	struct	stkclass *scptr;	/* Ptr to size class		*/
+	struct	stkclass *freecl;	/* An unused class, if any	*/
+	int32	i;
+
+	scptr = freecl = NULL;
+	for (i = 0; i < STKCNCLASS; i++) {
+		if (stkctab[i].scsize == nbytes) {
+			scptr = &stkctab[i];
+			break;
+		}
+		if ((freecl == NULL) && (stkctab[i].sccount == 0)) {
+			freecl = &stkctab[i];
+		}
+	}
+	if (scptr == NULL) {
+		scptr = freecl;
+	}
+	if ((scptr == NULL) || (scptr->sccount >= STKCDEPTH)
+	    || (stkcbytes + nbytes > STKCMAXBYTES)) {
+		freestk(saddr, nbytes);
+		return;
+	}
+
+	/* The top word is above anything a dying process still uses	*/
+
+	scptr->scsize = nbytes;
+	*(char **)saddr = scptr->sctop;
+	scptr->sctop = saddr;
+	scptr->sccount++;
+	stkcbytes += nbytes;
+}
+
+/*------------------------------------------------------------------------
+ *  stkcflush  -  Return every cached stack to the memory allocator
+ *------------------------------------------------------------------------
+ */
+void	stkcflush(void)
+{
+	intmask	mask;			/* Saved interrupt mask		*/
+	struct	stkclass *scptr;	/* Ptr to size class		*/
+	char	*saddr;			/* Stack being freed		*/
+	int32	i;
+
+	mask = disable();
+	for (i = 0; i < STKCNCLASS; i++) {
+		scptr = &stkctab[i];
+		while (scptr->sccount > 0) {
+			saddr = scptr->sctop;
+			scptr->sctop = *(char **)saddr;
+			scptr->sccount--;
+			freestk(saddr, scptr->scsize);
+		}
+		scptr->scsize = 0;
+	}
+	stkcbytes = 0;
+	restore(mask);
+}
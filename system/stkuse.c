@@ -0,0 +1,86 @@
+/* stkuse.c - stkuse, stkrecord */
+
+#include <xinu.h>
+
+struct	stkstat	stkstattab[NSTKSTAT];	/* Peak use per entry point	*/
+int32	nstkstat = 0;			/* Entries in use		*/
+
+/*------------------------------------------------------------------------
+ *  stkuse  -  Return the most stack a process has used so far, in
+ *		 bytes, by finding the lowest word create's paint no
+ *		 longer covers; SYSERR without -DSTKPAINT
+ *------------------------------------------------------------------------
+ */
+int32	stkuse(
+	  pid32		pid		/* ID of process to examine	*/
+	)
+{
+#ifndef	STKPAINT
+	return SYSERR;			/* Stacks are not painted	*/
+#else
+	intmask	mask;			/* Saved interrupt mask		*/
+	struct	procent	*prptr;		/* Ptr to process's table entry	*/
+	uint32	*low, *top;		/* Ends of the stack		*/
+	uint32	*p;			/* Word being examined		*/
+
+	mask = disable();
+	if (isbadpid(pid) || (pid == NULLPROC)) {	/* Null stack is	*/
+		restore(mask);				/*   never painted	*/
+		return SYSERR;
+	}
+	prptr = &proctab[pid];
+	top = (uint32 *)prptr->prstkbase;
+	low = (uint32 *)((uint32)top - prptr->prstklen + sizeof(uint32));
+	for (p = low; (p < top) && (*p == STKPATTERN); p++) {
+		;
+	}
+	restore(mask);
+	return (uint32)top + sizeof(uint32) - (uint32)p;
+#endif
+}
+
+/*------------------------------------------------------------------------
+ *  stkrecord  -  Add the peak stack use of a process that is being
+ *		    killed to the statistics for its entry point
+ *		    (assumes interrupts are disabled)
+ *------------------------------------------------------------------------
+ */
+void	stkrecord(
+	  pid32		pid		/* ID of process being killed	*/
+	)
+{
+	struct	procent	*prptr;		/* Ptr to process's table entry	*/
+	struct	stkstat	*ssptr;		/* Ptr to stats for entry point	*/
+	int32	peak;			/* Bytes the process used	*/
+	int32	i;
+
+	if ((peak = stkuse(pid)) == SYSERR) {
+		return;
+	}
+	prptr = &proctab[pid];
+	for (i = 0; i < nstkstat; i++) {
+		if (stkstattab[i].ssentry == prptr->prentry) {
+			break;
+		}
+	}
+	if (i == nstkstat) {
+		if (nstkstat >= NSTKSTAT) {
+			return;		/* Table full; entry not kept	*/
+		}
+		ssptr = &stkstattab[nstkstat++];
+		ssptr->ssentry = prptr->prentry;
+		for (i = 0; i < PNMLEN; i++) {
+			ssptr->ssname[i] = prptr->prname[i];
+		}
+		ssptr->sscount = ssptr->sssize = ssptr->sspeak = 0;
+	} else {
+		ssptr = &stkstattab[i];
+	}
+	ssptr->sscount++;
+	if (prptr->prstklen > ssptr->sssize) {
+		ssptr->sssize = prptr->prstklen;
+	}
+	if ((uint32)peak > ssptr->sspeak) {
+		ssptr->sspeak = peak;
+	}
+}
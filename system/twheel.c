@@ -0,0 +1,229 @@
+/* twheel.c - twinit, tw_insert, tw_cancel, tw_tick, tw_expire, tw_idle */
+
+#include <xinu.h>
+
+struct	twent	twtab[TWNENT];	/* Process timers and wheel slots	*/
+uint32	twnow;			/* Ticks processed by the wheel		*/
+
+/*------------------------------------------------------------------------
+ *  tw_unlink  -  Remove an entry from whatever list it is on
+ *------------------------------------------------------------------------
+ */
+local	void	tw_unlink(
+	  int32		e		/* Entry to remove		*/
+	)
+{
+	twtab[twtab[e].twprev].twnext = twtab[e].twnext;
+	twtab[twtab[e].twnext].twprev = twtab[e].twprev;
+	twtab[e].twnext = twtab[e].twprev = EMPTY;
+}
+
+/*------------------------------------------------------------------------
+ *  tw_append  -  Add an entry at the tail of a list
+ *------------------------------------------------------------------------
+ */
+local	void	tw_append(
+	  int32		h,		/* Head of the list		*/
+	  int32		e		/* Entry to add			*/
+	)
+{
+	int32	tail = twtab[h].twprev;
+
+	twtab[e].twnext = h;
+	twtab[e].twprev = tail;
+	twtab[tail].twnext = e;
+	twtab[h].twprev = e;
+}
+
+/*------------------------------------------------------------------------
+ *  tw_splice  -  Move every entry of one list to the tail of another
+ *------------------------------------------------------------------------
+ */
+local	void	tw_splice(
+	  int32		to,		/* Head of destination list	*/
+	  int32		from		/* Head of list to empty	*/
+	)
+{
+	int32	first, last, tail;
+
+	first = twtab[from].twnext;
+	if (first == from) {
+		return;
+	}
+	last = twtab[from].twprev;
+	tail = twtab[to].twprev;
+
+	twtab[tail].twnext = first;
+	twtab[first].twprev = tail;
+	twtab[last].twnext = to;
+	twtab[to].twprev = last;
+	twtab[from].twnext = twtab[from].twprev = from;
+}
+
+/*------------------------------------------------------------------------
+ *  tw_place  -  Put a process timer on the slot that matches how far
+ *		   in the future it expires
+ *------------------------------------------------------------------------
+ */
+local	void	tw_place(
+	  pid32		pid		/* Process whose timer to place	*/
+	)
+{
+	uint32	exp = twtab[pid].twexp;	/* Expiration tick		*/
+	uint32	delta;			/* Ticks until expiration	*/
+	int32	lev, shift;		/* Wheel level and its shift	*/
+
+	if ((int32)(exp - twnow) <= 0) {
+		tw_append(twhead(TWEXPIRED), pid);
+		return;
+	}
+	delta = exp - twnow;
+	if (delta < TWL0SIZE) {
+		tw_append(twhead(exp & (TWL0SIZE - 1)), pid);
+		return;
+	}
+	for (lev = 1; lev < TWNLEVEL - 1; lev++) {
+		if ((delta >> (TWL0BITS + lev * TWLNBITS)) == 0) {
+			break;
+		}
+	}
+	shift = TWL0BITS + (lev - 1) * TWLNBITS;
+	tw_append(twhead(TWL0SIZE + (lev - 1) * TWLNSIZE
+			+ ((exp >> shift) & (TWLNSIZE - 1))), pid);
+}
+
+/*------------------------------------------------------------------------
+ *  twinit  -  Initialize the timing wheel with every list empty
+ *------------------------------------------------------------------------
+ */
+void	twinit(void)
+{
+	int32	i;
+
+	for (i = 0; i < NPROC; i++) {
+		twtab[i].twnext = twtab[i].twprev = EMPTY;
+	}
+	for (i = NPROC; i < TWNENT; i++) {
+		twtab[i].twnext = twtab[i].twprev = i;
+	}
+	twnow = 0;
+}
+
+/*------------------------------------------------------------------------
+ *  tw_insert  -  Start a timer that expires delay ticks from now
+ *		    (assumes interrupts are disabled)
+ *------------------------------------------------------------------------
+ */
+status	tw_insert(
+	  pid32		pid,		/* Process that owns the timer	*/
+	  int32		delay		/* Ticks until expiration	*/
+	)
+{
+	if (isbadpid(pid) || (delay < 0) || twqueued(pid)) {
+		return SYSERR;
+	}
+	twtab[pid].twexp = twnow + delay;
+	tw_place(pid);
+	return OK;
+}
+
+/*------------------------------------------------------------------------
+ *  tw_cancel  -  Stop a timer before it expires (assumes interrupts
+ *		    are disabled)
+ *------------------------------------------------------------------------
+ */
+status	tw_cancel(
+	  pid32		pid		/* Process that owns the timer	*/
+	)
+{
+	if (isbadpid(pid) || !twqueued(pid)) {
+		return SYSERR;
+	}
+	tw_unlink(pid);
+	return OK;
+}
+
+/*------------------------------------------------------------------------
+ *  tw_tick  -  Advance the wheel by one tick from the clock interrupt;
+ *		  at most TWBUDGET cascaded timers are re-placed, and the
+ *		  rest wait on the pending list for the next tick.
+ *		  Returns TRUE if there are timers ready to be awakened.
+ *------------------------------------------------------------------------
+ */
+bool8	tw_tick(void)
+{
+	int32	lev, idx, shift;	/* Level, slot, and slot shift	*/
+	int32	n;			/* Entries re-placed so far	*/
+	int32	e;			/* Entry being re-placed	*/
+
+	twnow++;
+
+	/* Each time a level wraps, bring the next slot of the level	*/
+	/*   above it down onto the pending list			*/
+
+	if ((twnow & (TWL0SIZE - 1)) == 0) {
+		for (lev = 1; lev < TWNLEVEL; lev++) {
+			shift = TWL0BITS + (lev - 1) * TWLNBITS;
+			idx = (twnow >> shift) & (TWLNSIZE - 1);
+			tw_splice(twhead(TWPENDING), twhead(TWL0SIZE
+				+ (lev - 1) * TWLNSIZE + idx));
+			if (idx != 0) {
+				break;
+			}
+		}
+	}
+
+	for (n = 0; n < TWBUDGET && twnonempty(TWPENDING); n++) {
+		e = twtab[twhead(TWPENDING)].twnext;
+		tw_unlink(e);
+		tw_place(e);
+	}
+
+	tw_splice(twhead(TWEXPIRED), twhead(twnow & (TWL0SIZE - 1)));
+	return twnonempty(TWEXPIRED);
+}
+
+/*------------------------------------------------------------------------
+ *  tw_expire  -  Remove and return the next expired timer, or EMPTY
+ *		    (assumes interrupts are disabled)
+ *------------------------------------------------------------------------
+ */
+pid32	tw_expire(void)
+{
+	pid32	pid;
+
+	if (!twnonempty(TWEXPIRED)) {
+		return EMPTY;
+	}
+	pid = twtab[twhead(TWEXPIRED)].twnext;
+	tw_unlink(pid);
+	return pid;
+}
+
+/*------------------------------------------------------------------------
+ *  tw_idle  -  Return how many ticks (1 to max) may pass before the
+ *		  wheel next has work to do; never crosses a level 0
+ *		  wrap, where cascaded timers may become due
+ *------------------------------------------------------------------------
+ */
+uint32	tw_idle(
+	  uint32	max		/* Longest period of interest	*/
+	)
+{
+	uint32	limit;			/* Ticks until level 0 wraps	*/
+	uint32	n;
+
+	if (twnonempty(TWPENDING) || twnonempty(TWEXPIRED)) {
+		return 1;
+	}
+	limit = TWL0SIZE - (twnow & (TWL0SIZE - 1));
+	if (max > limit) {
+		max = limit;
+	}
+	for (n = 1; n < max; n++) {
+		if (twnonempty((twnow + n) & (TWL0SIZE - 1))) {
+			return n;
+		}
+	}
+	return (max > 0) ? max : 1;
+}
@@ -0,0 +1,133 @@
+/* udelay.c - delaycal, usecs2ticks, udelay, ndelay, spin_until */
+
+#include <xinu.h>
+
+/* Delays are measured with the TSC (getticks), which keeps counting	*/
+/*   while the caller is preempted.  Its rate is measured once against	*/
+/*   8254 counter 2, which runs at a known frequency and can be polled	*/
+/*   without interrupts, so calibration works before the clock is up.	*/
+
+#define	CLOCK2		(CLOCKBASE+2)	/* 8254 counter 2 data port	*/
+#define	PITGATE		0x61		/* Counter 2 gate and output	*/
+#define	PITHZ		1193182		/* 8254 input frequency		*/
+#define	DELAYCALMS	10		/* Length of calibration run	*/
+#define	DELAYSLEEPMS	2		/* Sleep if deadline is farther	*/
+
+uint32	tsccycms = 0;			/* TSC cycles per millisecond	*/
+local	uint32	tsccycus256 = 0;	/* Cycles per microsecond x 256	*/
+local	uint32	tsccycns64k = 0;	/* Cycles per nanosecond x 65536*/
+
+/*------------------------------------------------------------------------
+ *  delaycal  -  Measure the TSC rate over DELAYCALMS milliseconds of
+ *		   8254 counter 2 (called from clkinit at boot)
+ *------------------------------------------------------------------------
+ */
+void	delaycal(void)
+{
+	intmask	mask;			/* Saved interrupt mask		*/
+	uint32	count;			/* Counter 2 initial count	*/
+	uint64	start;			/* TSC when the count started	*/
+	uint32	cycles;			/* TSC cycles in the run	*/
+
+	mask = disable();
+	count = (PITHZ / 1000) * DELAYCALMS;
+
+	/* Gate counter 2 on with the speaker off, then start it in	*/
+	/*   mode 0 so its output goes high when the count runs out	*/
+
+	outb(PITGATE, (inb(PITGATE) & ~0x02) | 0x01);
+	outb(CLKCNTL, 0xb0);		/* Counter 2, lsb/msb, mode 0	*/
+	outb(CLOCK2, (char) (0xff & count));
+	outb(CLOCK2, (char) (0xff & (count >> 8)));
+
+	start = getticks();
+	while ((inb(PITGATE) & 0x20) == 0) {
+		;
+	}
+	cycles = (uint32) (getticks() - start);
+
+	tsccycms = cycles / DELAYCALMS;
+	tsccycus256 = (tsccycms << 8) / 1000;
+	tsccycns64k = (tsccycus256 << 8) / 1000;
+	restore(mask);
+}
+
+/*------------------------------------------------------------------------
+ *  usecs2ticks  -  Convert microseconds to TSC cycles, for building a
+ *		      deadline for spin_until
+ *------------------------------------------------------------------------
+ */
+uint64	usecs2ticks(
+	  uint32	usecs		/* Microseconds to convert	*/
+	)
+{
+	if (tsccycms == 0) {
+		delaycal();
+	}
+	return ((uint64) usecs * tsccycus256) >> 8;
+}
+
+/*------------------------------------------------------------------------
+ *  udelay  -  Busy-wait for at least usecs microseconds; safe with
+ *		 interrupts disabled
+ *------------------------------------------------------------------------
+ */
+void	udelay(
+	  uint32	usecs		/* Microseconds to wait		*/
+	)
+{
+	uint64	deadline;		/* TSC at which to stop		*/
+
+	deadline = getticks() + usecs2ticks(usecs);
+	while ((int64) (deadline - getticks()) > 0) {
+		;
+	}
+}
+
+/*------------------------------------------------------------------------
+ *  ndelay  -  Busy-wait for at least nsecs nanoseconds; safe with
+ *		 interrupts disabled
+ *------------------------------------------------------------------------
+ */
+void	ndelay(
+	  uint32	nsecs		/* Nanoseconds to wait		*/
+	)
+{
+	uint64	deadline;		/* TSC at which to stop		*/
+
+	if (tsccycms == 0) {
+		delaycal();
+	}
+	deadline = getticks() + (((uint64) nsecs * tsccycns64k) >> 16);
+	while ((int64) (deadline - getticks()) > 0) {
+		;
+	}
+}
+
+/*------------------------------------------------------------------------
+ *  spin_until  -  Wait until the TSC reaches deadline; while it is more
+ *		     than DELAYSLEEPMS away the caller sleeps so that other
+ *		     processes can run, and it spins only for the last part
+ *------------------------------------------------------------------------
+ */
+void	spin_until(
+	  uint64	deadline	/* TSC value to wait for	*/
+	)
+{
+	uint64	left;			/* Cycles remaining		*/
+	uint32	msecs;			/* Whole milliseconds remaining	*/
+
+	if (tsccycms == 0) {
+		delaycal();
+	}
+	while ((int64) (left = deadline - getticks()) > 0) {
+		if ((left >> 32) != 0) {
+			msecs = 1000;	/* Far away; avoid 64-bit divide*/
+		} else {
+			msecs = (uint32) left / tsccycms;
+		}
+		if (msecs > DELAYSLEEPMS) {
+			sleepms(msecs - 1);
+		}
+	}
+}
@@ -0,0 +1,35 @@
+/* unsleep.c - unsleep */
+
+#include <xinu.h>
+
+/*------------------------------------------------------------------------
+ *  unsleep  -  Internal function to remove a process from the timing
+ *		    wheel prematurely
+ *------------------------------------------------------------------------
+ */
+status	unsleep(
+	  pid32		pid		/* ID of process to remove	*/
+        )
+{
+	intmask	mask;			/* Saved interrupt mask		*/
+        struct	procent	*prptr;		/* Ptr to process's table entry	*/
+
+	mask = disable();
+
+	if (isbadpid(pid)) {
+		restore(mask);
+		return SYSERR;
+	}
+
+	/* Verify that candidate process has a timer running */
+
+	prptr = &proctab[pid];
+	if ((prptr->prstate!=PR_SLEEP) && (prptr->prstate!=PR_RECTIM)) {
+		restore(mask);
+		return SYSERR;
+	}
+
+	tw_cancel(pid);			/* Unlink timer from its slot	*/
+	restore(mask);
+	return OK;
+}
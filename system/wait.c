@@ -0,0 +1,42 @@
+/* wait.c - wait */
+
+#include <xinu.h>
+
+/*------------------------------------------------------------------------
+ *  wait  -  Cause current process to wait on a semaphore
+ *------------------------------------------------------------------------
+ */
+syscall	wait(
+	  sid32		sem		/* Semaphore on which to wait  */
+	)
+{
+	intmask mask;			/* Saved interrupt mask		*/
+	struct	procent *prptr;		/* Ptr to process' table entry	*/
+	struct	sentry *semptr;		/* Ptr to sempahore table entry	*/
+
+	mask = disable();
+	if (isbadsem(sem)) {
+		restore(mask);
+		return SYSERR;
+	}
+
+	semptr = &semtab[sem];
+	if (semptr->sstate == S_FREE) {
+		restore(mask);
+		return SYSERR;
+	}
+
+	if (--(semptr->scount) < 0) {		/* If caller must block	*/
+		prptr = &proctab[currpid];
+		prptr->prstate = PR_WAIT;	/* Set state to waiting	*/
+		prptr->prsem = sem;		/* Record semaphore ID	*/
+		enqueue(currpid,semptr->squeue);/* Enqueue on semaphore	*/
+		deadlock_check(currpid);	/* Only blocking waits	*/
+		resched();			/*   and reschedule	*/
+	} else if (semptr->smutex) {
+		semhold(sem, currpid);		/* Took the only unit	*/
+	}
+
+	restore(mask);
+	return OK;
+}
@@ -0,0 +1,25 @@
+/* wakeup.c - wakeup */
+
+#include <xinu.h>
+
+/*------------------------------------------------------------------------
+ * wakeup  -  Called by clock interrupt handler to awaken processes
+ *		whose timers have expired; at most TWBUDGET are made
+ *		ready per call and the rest wait for the next tick
+ *------------------------------------------------------------------------
+ */
+void	wakeup(void)
+{
+	int32	n;			/* Processes awakened so far	*/
+	pid32	pid;			/* Process whose timer expired	*/
+
+	resched_cntl(DEFER_START);
+	for (n = 0; n < TWBUDGET && (pid = tw_expire()) != EMPTY; n++) {
+		if ((proctab[pid].prstate == PR_SLEEP) ||
+		    (proctab[pid].prstate == PR_RECTIM)) {
+			ready(pid);
+		}
+	}
+	resched_cntl(DEFER_STOP);
+	return;
+}
@@ -0,0 +1,196 @@
+/* watchdog.c - wdstart, wdsample, wdhold, wdwait, wdog */
+
+#include <xinu.h>
+
+struct	wdproc	{			/* A process at the last sample	*/
+	void	*wpwaiton;		/* Lock it waited on, or NULL	*/
+	uint32	wpwaitsince;		/* When that wait was first seen*/
+	uint32	wpholdsince;		/* When it was first seen with	*/
+					/*   a pi lock held		*/
+	bool8	wpholding;		/* It held a pi lock		*/
+	bool8	wpwaitwarned;		/* This wait was reported	*/
+	bool8	wpholdwarned;		/* This hold was reported	*/
+	bool8	wptrywarned;		/* This streak was reported	*/
+};
+
+local	struct	wdproc	wdproctab[NPROC];
+local	pid32	wdalholder[NALOCKS];	/* Holder of each al lock at	*/
+local	uint32	wdalsince[NALOCKS];	/*   the last sample, since when*/
+local	bool8	wdalwarned[NALOCKS];	/*   and whether reported	*/
+local	pid32	wdpid = -1;		/* Watchdog process, once started*/
+
+local	process	wdog(void);
+
+/*------------------------------------------------------------------------
+ *  wdhold  -  Sample the al locks and the pi locks held by each process
+ *------------------------------------------------------------------------
+ */
+local	void	wdhold(
+	  uint32	now		/* ctr1000 at this sample	*/
+	)
+{
+	struct	wdproc	*wp;		/* Watchdog state of a process	*/
+	pid32	holder;
+	int32	i;
+
+	for (i = 0; i < NALOCKS; i++) {
+		holder = (pid32)locks[i];
+		if ((holder <= NULLPROC) || isbadpid(holder)) {
+			wdalholder[i] = -1;	/* Free or never used	*/
+			continue;
+		}
+		if (holder != wdalholder[i]) {
+			wdalholder[i] = holder;
+			wdalsince[i] = now;
+			wdalwarned[i] = FALSE;
+		} else if (!wdalwarned[i] && (now - wdalsince[i] > WDHOLDMS)) {
+			klog("watchdog=hold lock=al%d holder=P%d ms=%u\n", i,
+				holder, now - wdalsince[i]);
+			wdalwarned[i] = TRUE;
+		}
+	}
+
+	/* pi locks have no table, so follow each holder's piheld list	*/
+	/*   and time how long it has held at least one			*/
+
+	for (i = 1; i < NPROC; i++) {
+		wp = &wdproctab[i];
+		if (isbadpid(i) || (proctab[i].piheld == NULL)) {
+			wp->wpholding = FALSE;
+			continue;
+		}
+		if (!wp->wpholding) {
+			wp->wpholding = TRUE;
+			wp->wpholdsince = now;
+			wp->wpholdwarned = FALSE;
+		} else if (!wp->wpholdwarned
+			   && (now - wp->wpholdsince > WDHOLDMS)) {
+			klog("watchdog=hold lock=pi holder=P%d ms=%u\n", i,
+				now - wp->wpholdsince);
+			wp->wpholdwarned = TRUE;
+		}
+	}
+}
+
+/*------------------------------------------------------------------------
+ *  wdwait  -  Sample what each process is waiting or spinning on, and
+ *		 its al_trylock failure streak
+ *------------------------------------------------------------------------
+ */
+local	void	wdwait(
+	  uint32	now		/* ctr1000 at this sample	*/
+	)
+{
+	struct	procent	*prptr;		/* Ptr to process's table entry	*/
+	struct	wdproc	*wp;		/* Watchdog state of a process	*/
+	void	*waiton;		/* Lock waited on, or NULL	*/
+	int16	alid;			/* al lock ID, if that kind	*/
+	pi_lock_t *pilock;		/* pi lock, if that kind	*/
+	pid32	i;
+
+	for (i = 1; i < NPROC; i++) {
+		wp = &wdproctab[i];
+		if (isbadpid(i)) {
+			wp->wpwaiton = NULL;
+			wp->wptrywarned = FALSE;
+			continue;
+		}
+		prptr = &proctab[i];
+		alid = prptr->pendingLockId;
+		pilock = prptr->pendingLock;
+		if (alid >= 0) {
+			waiton = &locks[alid];
+		} else if (pilock != NULL) {
+			waiton = pilock;
+		} else {
+			waiton = prptr->prspinon;
+		}
+
+		if (waiton != wp->wpwaiton) {
+			wp->wpwaiton = waiton;
+			wp->wpwaitsince = now;
+			wp->wpwaitwarned = FALSE;
+		} else if ((waiton != NULL) && !wp->wpwaitwarned
+			   && (now - wp->wpwaitsince > WDWAITMS)) {
+			if (alid >= 0) {
+				klog("watchdog=wait lock=al%d waiter=P%d "
+					"holder=P%d ms=%u\n", alid, i,
+					locks[alid], now - wp->wpwaitsince);
+			} else if (pilock != NULL) {
+				klog("watchdog=wait lock=pi waiter=P%d "
+					"holder=P%d ms=%u\n", i,
+					pilock->curr_holder,
+					now - wp->wpwaitsince);
+			} else {
+				klog("watchdog=spin lock=sl waiter=P%d "
+					"ms=%u\n", i, now - wp->wpwaitsince);
+			}
+			wp->wpwaitwarned = TRUE;
+		}
+
+		if (prptr->prtryfail < WDTRYFAIL) {
+			wp->wptrywarned = FALSE;
+		} else if (!wp->wptrywarned) {
+			klog("watchdog=trylock waiter=P%d failures=%u\n", i,
+				prptr->prtryfail);
+			wp->wptrywarned = TRUE;
+		}
+	}
+}
+
+/*------------------------------------------------------------------------
+ *  wdsample  -  Take one sample of lock state and report holds, waits,
+ *		   and trylock streaks that have gone on too long; the
+ *		   fields are read without locking, since a stale value
+ *		   can only delay a report by one period
+ *------------------------------------------------------------------------
+ */
+void	wdsample(void)
+{
+	uint32	now = ctr1000;
+
+	wdhold(now);
+	wdwait(now);
+}
+
+/*------------------------------------------------------------------------
+ *  wdstart  -  Start the watchdog process
+ *------------------------------------------------------------------------
+ */
+syscall	wdstart(void)
+{
+	intmask	mask;			/* Saved interrupt mask		*/
+	pid32	pid;
+	int32	i;
+
+	mask = disable();
+	if (wdpid != -1) {
+		restore(mask);
+		return OK;
+	}
+	for (i = 0; i < NALOCKS; i++) {
+		wdalholder[i] = -1;
+	}
+	pid = create(wdog, WDSTK, WDPRIO, "watchdog", 0);
+	if (pid == SYSERR) {
+		restore(mask);
+		return SYSERR;
+	}
+	wdpid = pid;
+	resume(pid);
+	restore(mask);
+	return OK;
+}
+
+/*------------------------------------------------------------------------
+ *  wdog  -  Sample every WDPERIOD milliseconds
+ *------------------------------------------------------------------------
+ */
+local	process	wdog(void)
+{
+	while (TRUE) {
+		sleepms(WDPERIOD);
+		wdsample();
+	}
+	return OK;
+}
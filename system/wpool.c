@@ -0,0 +1,208 @@
+/* wpool.c - pool_create, pool_submit, pool_wait, pool_delete, wpworker */
+
+#include <xinu.h>
+
+struct	wpentry	wptab[NWPOOL];		/* Worker pool table		*/
+
+local	process	wpworker(int32);
+
+/*------------------------------------------------------------------------
+ *  pool_create  -  Start a pool of nwork worker processes that run
+ *		      submitted tasks at priority prio; returns a pool ID
+ *------------------------------------------------------------------------
+ */
+int32	pool_create(
+	  int32		nwork,		/* Number of workers		*/
+	  pri16		prio		/* Priority of the workers	*/
+	)
+{
+	intmask	mask;			/* Saved interrupt mask		*/
+	struct	wpentry	*wpptr;		/* Ptr to pool table entry	*/
+	int32	pool;			/* ID of the new pool		*/
+	int32	i;
+
+	mask = disable();
+	if ((nwork < 1) || (nwork > WPMAXWORK) || (prio < 1)) {
+		restore(mask);
+		return SYSERR;
+	}
+	for (pool = 0; pool < NWPOOL; pool++) {
+		if (wptab[pool].wpstate == WP_FREE) {
+			break;
+		}
+	}
+	if (pool >= NWPOOL) {
+		restore(mask);
+		return SYSERR;
+	}
+	wpptr = &wptab[pool];
+	wpptr->wptasks = semcreate(0);
+	wpptr->wpslots = semcreate(WPQLEN);
+	wpptr->wpdone = semcreate(0);
+	if ((wpptr->wptasks == SYSERR) || (wpptr->wpslots == SYSERR)
+	    || (wpptr->wpdone == SYSERR)) {
+		semdelete(wpptr->wptasks);
+		semdelete(wpptr->wpslots);
+		semdelete(wpptr->wpdone);
+		restore(mask);
+		return SYSERR;
+	}
+	wpptr->wpstate = WP_USED;
+	wpptr->wphead = wpptr->wpcount = 0;
+	wpptr->wppending = wpptr->wpnwait = 0;
+
+	wpptr->wpnwork = 0;
+	for (i = 0; i < nwork; i++) {
+		wpptr->wpwork[i] = create(wpworker, WPSTK, prio, "worker",
+					1, pool);
+		if (wpptr->wpwork[i] == SYSERR) {
+			break;
+		}
+		wpptr->wpnwork++;
+		resume(wpptr->wpwork[i]);
+	}
+	if (wpptr->wpnwork == 0) {
+		pool_delete(pool);
+		restore(mask);
+		return SYSERR;
+	}
+	restore(mask);
+	return pool;
+}
+
+/*------------------------------------------------------------------------
+ *  pool_submit  -  Queue fn(arg) to run on a worker, waiting if the
+ *		      task ring is full
+ *------------------------------------------------------------------------
+ */
+syscall	pool_submit(
+	  int32		pool,		/* ID of the pool		*/
+	  void		(*fn)(void *),	/* Function to run		*/
+	  void		*arg		/* Argument passed to fn	*/
+	)
+{
+	intmask	mask;			/* Saved interrupt mask		*/
+	struct	wpentry	*wpptr;		/* Ptr to pool table entry	*/
+	struct	wptask	*tptr;		/* Slot for the new task	*/
+
+	mask = disable();
+	if (isbadwpool(pool) || (fn == NULL)) {
+		restore(mask);
+		return SYSERR;
+	}
+	wpptr = &wptab[pool];
+	if ((wait(wpptr->wpslots) == SYSERR)
+	    || (wpptr->wpstate == WP_FREE)) {
+		restore(mask);		/* Pool deleted while waiting	*/
+		return SYSERR;
+	}
+	tptr = &wpptr->wpq[(wpptr->wphead + wpptr->wpcount) % WPQLEN];
+	tptr->wtfunc = fn;
+	tptr->wtarg = arg;
+	wpptr->wpcount++;
+	wpptr->wppending++;
+	signal(wpptr->wptasks);		/* Start an idle worker		*/
+	restore(mask);
+	return OK;
+}
+
+/*------------------------------------------------------------------------
+ *  pool_wait  -  Block until every task submitted to a pool has run
+ *------------------------------------------------------------------------
+ */
+syscall	pool_wait(
+	  int32		pool		/* ID of the pool		*/
+	)
+{
+	intmask	mask;			/* Saved interrupt mask		*/
+	struct	wpentry	*wpptr;		/* Ptr to pool table entry	*/
+
+	mask = disable();
+	if (isbadwpool(pool)) {
+		restore(mask);
+		return SYSERR;
+	}
+	wpptr = &wptab[pool];
+	if (wpptr->wppending > 0) {
+		wpptr->wpnwait++;
+		if (wait(wpptr->wpdone) == SYSERR) {
+			restore(mask);
+			return SYSERR;
+		}
+	}
+	restore(mask);
+	return OK;
+}
+
+/*------------------------------------------------------------------------
+ *  pool_delete  -  Kill the workers of a pool and free its entry; tasks
+ *		      still queued are dropped, so call pool_wait first
+ *------------------------------------------------------------------------
+ */
+syscall	pool_delete(
+	  int32		pool		/* ID of the pool		*/
+	)
+{
+	intmask	mask;			/* Saved interrupt mask		*/
+	struct	wpentry	*wpptr;		/* Ptr to pool table entry	*/
+	int32	i;
+
+	mask = disable();
+	if (isbadwpool(pool)) {
+		restore(mask);
+		return SYSERR;
+	}
+	wpptr = &wptab[pool];
+	wpptr->wpstate = WP_FREE;
+	for (i = 0; i < wpptr->wpnwork; i++) {
+		kill(wpptr->wpwork[i]);
+	}
+	wpptr->wpnwork = 0;
+
+	/* Deleting the semaphores releases submitters and waiters	*/
+
+	semdelete(wpptr->wptasks);
+	semdelete(wpptr->wpslots);
+	semdelete(wpptr->wpdone);
+	restore(mask);
+	return OK;
+}
+
+/*------------------------------------------------------------------------
+ *  wpworker  -  Run tasks from a pool's ring, waiting while it is empty
+ *------------------------------------------------------------------------
+ */
+local	process	wpworker(
+	  int32		pool		/* ID of the pool		*/
+	)
+{
+	intmask	mask;			/* Saved interrupt mask		*/
+	struct	wpentry	*wpptr;		/* Ptr to pool table entry	*/
+	struct	wptask	task;		/* Copy of the task to run	*/
+
+	wpptr = &wptab[pool];
+	while (TRUE) {
+		mask = disable();
+		if (wait(wpptr->wptasks) == SYSERR) {
+			restore(mask);
+			return SYSERR;
+		}
+		task = wpptr->wpq[wpptr->wphead];
+		wpptr->wphead = (wpptr->wphead + 1) % WPQLEN;
+		wpptr->wpcount--;
+		signal(wpptr->wpslots);
+		restore(mask);
+
+		(*task.wtfunc)(task.wtarg);
+
+		/* Release pool_wait callers when the last task finishes */
+
+		mask = disable();
+		if ((--wpptr->wppending == 0) && (wpptr->wpnwait > 0)) {
+			signaln(wpptr->wpdone, wpptr->wpnwait);
+			wpptr->wpnwait = 0;
+		}
+		restore(mask);
+	}
+	return OK;
+}
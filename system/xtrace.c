@@ -0,0 +1,71 @@
+/* xtrace.c - xtrace_rec, xtracedump, xtraceclear */
+
+#include <xinu.h>
+
+#ifdef	XTRACE
+
+local	struct	xtrec	xtbuf[XTRACELEN];	/* Ring of records	*/
+local	uint32	xtcount = 0;			/* Records ever written	*/
+
+/*------------------------------------------------------------------------
+ *  xtrace_rec  -  Append one record to the trace buffer
+ *------------------------------------------------------------------------
+ */
+void	xtrace_rec(
+	  uint16	type,		/* XT_* event and XTF_* flavor	*/
+	  pid32		pid,		/* Process the event concerns	*/
+	  uint32	arg		/* Event argument		*/
+	)
+{
+	intmask	mask;			/* Saved interrupt mask		*/
+	struct	xtrec	*xtptr;		/* Record being written		*/
+
+	mask = disable();
+	xtptr = &xtbuf[xtcount % XTRACELEN];
+	xtcount++;
+	xtptr->xttsc = getticks();
+	xtptr->xttype = type;
+	xtptr->xtpid = (uint16) pid;
+	xtptr->xtarg = arg;
+	restore(mask);
+}
+
+/*------------------------------------------------------------------------
+ *  xtracedump  -  Print the buffer, oldest record first, as hex lines
+ *		     between markers that tools/xtrace2json.py looks for
+ *------------------------------------------------------------------------
+ */
+void	xtracedump(void)
+{
+	intmask	mask;			/* Saved interrupt mask		*/
+	struct	xtrec	*xtptr;		/* Record being printed		*/
+	uint32	first, i;		/* Oldest record kept, index	*/
+
+	mask = disable();
+	first = (xtcount > XTRACELEN) ? xtcount - XTRACELEN : 0;
+	kprintf("XTRACE-BEGIN tsc_per_ms=%u records=%u lost=%u\n",
+		tsccycms, xtcount - first, first);
+	for (i = first; i < xtcount; i++) {
+		xtptr = &xtbuf[i % XTRACELEN];
+		kprintf("%08x%08x %04x %04x %08x\n",
+			(uint32)(xtptr->xttsc >> 32), (uint32)xtptr->xttsc,
+			xtptr->xttype, xtptr->xtpid, xtptr->xtarg);
+	}
+	kprintf("XTRACE-END\n");
+	restore(mask);
+}
+
+/*------------------------------------------------------------------------
+ *  xtraceclear  -  Discard everything recorded so far
+ *------------------------------------------------------------------------
+ */
+void	xtraceclear(void)
+{
+	intmask	mask;			/* Saved interrupt mask		*/
+
+	mask = disable();
+	xtcount = 0;
+	restore(mask);
+}
+
+#endif
@@ -0,0 +1,132 @@
+#!/usr/bin/env python3
+"""Convert an xtracedump console capture to Chrome trace JSON.
+
+Usage: xtrace2json.py [capture.txt] > trace.json
+
+The capture may contain other console output; only the lines between
+XTRACE-BEGIN and XTRACE-END are used.  Load the result in
+chrome://tracing or https://ui.perfetto.dev.
+
+Layout of the output:
+  * "CPU" track: one slice per stretch a process held the CPU.
+  * One track per process: lock holds and waits as async slices,
+    park/unpark as instant events, and priority as a counter.
+"""
+
+import json
+import re
+import sys
+
+XT_SWITCH, XT_PARK, XT_UNPARK = 1, 2, 3
+XT_ACQUIRE, XT_CONTEND, XT_RELEASE, XT_PRIO = 4, 5, 6, 7
+
+FLAVORS = {0x00: "lock", 0x01: "al_lock", 0x02: "pi_lock", 0x03: "sl_lock"}
+
+CPU_PID = 0                     # Chrome "process" holding the CPU track
+PROC_PID = 1                    # Chrome "process" holding per-pid tracks
+
+BEGIN = re.compile(r"XTRACE-BEGIN tsc_per_ms=(\d+)")
+RECORD = re.compile(r"^([0-9a-fA-F]{16}) ([0-9a-fA-F]{4}) "
+                    r"([0-9a-fA-F]{4}) ([0-9a-fA-F]{8})$")
+
+
+def parse(lines):
+    """Return (tsc_per_ms, [(tsc, type, pid, arg), ...])."""
+    tsc_per_ms, records, inside = 0, [], False
+    for line in lines:
+        line = line.strip()
+        m = BEGIN.search(line)
+        if m:
+            tsc_per_ms, records, inside = int(m.group(1)), [], True
+            continue
+        if line.startswith("XTRACE-END"):
+            inside = False
+            continue
+        if inside:
+            m = RECORD.match(line)
+            if m:
+                records.append(tuple(int(g, 16) for g in m.groups()))
+    if not records:
+        sys.exit("xtrace2json: no XTRACE-BEGIN/END block found")
+    if tsc_per_ms == 0:
+        tsc_per_ms = 1000       # Uncalibrated: treat cycles as ns
+    return tsc_per_ms, records
+
+
+def convert(tsc_per_ms, records):
+    base = records[0][0]
+    per_us = tsc_per_ms / 1000.0
+    events = []
+    running = None              # (pid, start us) of the CPU holder
+    waits = {}                  # (pid, lock) -> start us of contention
+    pids = set()
+
+    def us(tsc):
+        return (tsc - base) / per_us
+
+    def lockname(kind, arg):
+        return "%s %#x" % (FLAVORS.get(kind >> 8, "lock?"), arg)
+
+    for tsc, kind, pid, arg in records:
+        t = us(tsc)
+        event = kind & 0xff
+        pids.add(pid)
+
+        if event == XT_SWITCH:
+            if running is not None:
+                events.append({"name": "P%d" % running[0], "ph": "X",
+                               "pid": CPU_PID, "tid": 0, "ts": running[1],
+                               "dur": t - running[1]})
+            running = (arg, t)
+            pids.add(arg)
+        elif event == XT_CONTEND:
+            waits[(pid, arg)] = t
+            events.append({"name": "wait " + lockname(kind, arg),
+                           "cat": "wait", "ph": "b", "id": "w%d-%x" % (pid, arg),
+                           "pid": PROC_PID, "tid": pid, "ts": t})
+        elif event == XT_ACQUIRE:
+            if waits.pop((pid, arg), None) is not None:
+                events.append({"name": "wait " + lockname(kind, arg),
+                               "cat": "wait", "ph": "e",
+                               "id": "w%d-%x" % (pid, arg),
+                               "pid": PROC_PID, "tid": pid, "ts": t})
+            events.append({"name": "hold " + lockname(kind, arg),
+                           "cat": "hold", "ph": "b", "id": "h%d-%x" % (pid, arg),
+                           "pid": PROC_PID, "tid": pid, "ts": t})
+        elif event == XT_RELEASE:
+            events.append({"name": "hold " + lockname(kind, arg),
+                           "cat": "hold", "ph": "e", "id": "h%d-%x" % (pid, arg),
+                           "pid": PROC_PID, "tid": pid, "ts": t})
+        elif event in (XT_PARK, XT_UNPARK):
+            events.append({"name": "park" if event == XT_PARK else "unpark",
+                           "ph": "i", "s": "t", "pid": PROC_PID, "tid": pid,
+                           "ts": t, "args": {"lock": "%#x" % arg}})
+        elif event == XT_PRIO:
+            events.append({"name": "prio P%d" % pid, "ph": "C",
+                           "pid": PROC_PID, "tid": pid, "ts": t,
+                           "args": {"prio": arg & 0xffff}})
+
+    if running is not None:
+        end = us(records[-1][0])
+        events.append({"name": "P%d" % running[0], "ph": "X",
+                       "pid": CPU_PID, "tid": 0, "ts": running[1],
+                       "dur": end - running[1]})
+
+    meta = [{"name": "process_name", "ph": "M", "pid": CPU_PID,
+             "args": {"name": "CPU"}},
+            {"name": "process_name", "ph": "M", "pid": PROC_PID,
+             "args": {"name": "Processes"}}]
+    meta += [{"name": "thread_name", "ph": "M", "pid": PROC_PID, "tid": p,
+              "args": {"name": "P%d" % p}} for p in sorted(pids)]
+    return {"traceEvents": meta + events, "displayTimeUnit": "ns"}
+
+
+def main():
+    src = open(sys.argv[1]) if len(sys.argv) > 1 else sys.stdin
+    tsc_per_ms, records = parse(src)
+    json.dump(convert(tsc_per_ms, records), sys.stdout, indent=1)
+    sys.stdout.write("\n")
+
+
+if __name__ == "__main__":
+    main()